@@ -0,0 +1,459 @@
+#-------------------------------------------------------------------------------
+# SPDX-License-Identifier: MIT
+# 
+# Copyright (c) 2025 SparkFun Electronics
+#-------------------------------------------------------------------------------
+# cv2_bench.py
+# 
+# Benchmark suite for the MicroPython port of OpenCV. Times every function
+# exported by the cv2 module over standard gray and BGR test images, with and
+# without a preallocated output array, and reports the results as JSON. Results
+# can be saved and used as a baseline for later runs to catch regressions.
+# 
+# Usage on the unix port:
+#   micropython cv2_bench.py [--repeat N] [--sizes 160x120,320x240]
+#       [--only blur,Canny] [--save FILE] [--baseline FILE] [--tolerance 0.1]
+# 
+# Usage on a board, after copying this file to its filesystem:
+#   import cv2_bench
+#   cv2_bench.main(["--save", "baseline.json"])
+#-------------------------------------------------------------------------------
+
+import cv2 as cv
+from ulab import numpy as np
+import gc
+import json
+import math
+import sys
+import time
+
+# Default benchmark settings
+SIZES = ((160, 120), (320, 240), (640, 480))
+REPEAT = 10
+TOLERANCE = 0.1
+
+# Exported functions that need a display or a filesystem, that only change
+# settings, or that are part of the benchmark instrumentation itself, so are
+# not timed
+SKIP = {
+    "getNumThreads": "setting",
+    "setNumThreads": "setting",
+    "imshow": "needs a display",
+    "waitKey": "needs a display",
+    "waitKeyEx": "needs a display",
+    "imread": "needs a filesystem",
+    "imwrite": "needs a filesystem",
+    "alloc_stats": "instrumentation",
+    "fast_stats": "instrumentation",
+    "set_fast_region": "setting",
+    "profile": "instrumentation",
+    "profile_reset": "instrumentation",
+    "pool_stats": "instrumentation",
+    "pool_clear": "instrumentation",
+}
+
+# Benchmark specifications. Each entry is (name, per_size, call, dst), where:
+# - name is the name of the function in the cv2 module
+# - per_size is True if the function is run on every image size, or False if it
+#   operates on a point set that does not depend on the image size
+# - call(inputs, **kwargs) calls the function with the standard inputs
+# - dst(result) returns the keyword arguments to pass a preallocated output, or
+#   None if the function has no output array
+def _dst(key, index=None):
+    if index is None:
+        return lambda r: {key: r}
+    return lambda r: {key: r[index]}
+
+SPECS = (
+    # core
+    ("convertScaleAbs", True, lambda i, **k: cv.convertScaleAbs(i["gray"], alpha=1.5, beta=10, **k), _dst("dst")),
+    ("frombuffer", True, lambda i, **k: cv.frombuffer(i["frame565"], (i["h"], i["w"]), cv.CV_16UC1), None),
+    ("inRange", True, lambda i, **k: cv.inRange(i["bgr"], (0, 0, 100), (100, 100, 255), **k), _dst("dst")),
+    ("inRangeHSV", True, lambda i, **k: cv.inRangeHSV(i["bgr"], (170, 100, 100), (10, 255, 255), **k), _dst("dst")),
+    ("minMaxLoc", True, lambda i, **k: cv.minMaxLoc(i["gray"]), None),
+
+    # imgproc, image filtering
+    ("bilateralFilter", True, lambda i, **k: cv.bilateralFilter(i["gray"], 5, 50, 50, **k), _dst("dst")),
+    ("blur", True, lambda i, **k: cv.blur(i["gray"], (5, 5), **k), _dst("dst")),
+    ("boxFilter", True, lambda i, **k: cv.boxFilter(i["gray"], -1, (5, 5), **k), _dst("dst")),
+    ("dilate", True, lambda i, **k: cv.dilate(i["gray"], i["kernel"], **k), _dst("dst")),
+    ("erode", True, lambda i, **k: cv.erode(i["gray"], i["kernel"], **k), _dst("dst")),
+    ("filter2D", True, lambda i, **k: cv.filter2D(i["gray"], -1, i["sharpen"], **k), _dst("dst")),
+    ("GaussianBlur", True, lambda i, **k: cv.GaussianBlur(i["gray"], (5, 5), 0, **k), _dst("dst")),
+    ("getStructuringElement", False, lambda i, **k: cv.getStructuringElement(cv.MORPH_ELLIPSE, (5, 5)), None),
+    ("Laplacian", True, lambda i, **k: cv.Laplacian(i["gray"], cv.CV_16S, **k), _dst("dst")),
+    ("medianBlur", True, lambda i, **k: cv.medianBlur(i["gray"], 5, **k), _dst("dst")),
+    ("morphologyEx", True, lambda i, **k: cv.morphologyEx(i["gray"], cv.MORPH_OPEN, i["kernel"], **k), _dst("dst")),
+    ("Scharr", True, lambda i, **k: cv.Scharr(i["gray"], cv.CV_16S, 1, 0, **k), _dst("dst")),
+    ("Sobel", True, lambda i, **k: cv.Sobel(i["gray"], cv.CV_16S, 1, 0, **k), _dst("dst")),
+    ("spatialGradient", True, lambda i, **k: cv.spatialGradient(i["gray"], **k), lambda r: {"dx": r[0], "dy": r[1]}),
+
+    # imgproc, miscellaneous image transformations
+    ("adaptiveThreshold", True, lambda i, **k: cv.adaptiveThreshold(i["gray"], 255, cv.ADAPTIVE_THRESH_MEAN_C, cv.THRESH_BINARY, 11, 2, **k), _dst("dst")),
+    ("threshold", True, lambda i, **k: cv.threshold(i["gray"], 127, 255, cv.THRESH_BINARY, **k), _dst("dst", 1)),
+
+    # imgproc, color space conversions
+    ("cvtColor", True, lambda i, **k: cv.cvtColor(i["bgr"], cv.COLOR_BGR2HSV, **k), _dst("dst")),
+
+    # imgproc, drawing functions. These draw into the canvas, so there is no
+    # separate output array
+    ("arrowedLine", True, lambda i, **k: cv.arrowedLine(i["canvas"], (10, 10), (i["w"] - 10, i["h"] - 10), (0, 255, 0), 2), None),
+    ("circle", True, lambda i, **k: cv.circle(i["canvas"], (i["w"] // 2, i["h"] // 2), i["h"] // 4, (0, 0, 255), 2), None),
+    ("drawContours", True, lambda i, **k: cv.drawContours(i["canvas"], i["contours"], -1, (0, 255, 0), 2), None),
+    ("drawMarker", True, lambda i, **k: cv.drawMarker(i["canvas"], (i["w"] // 2, i["h"] // 2), (0, 0, 255)), None),
+    ("ellipse", True, lambda i, **k: cv.ellipse(i["canvas"], (i["w"] // 2, i["h"] // 2), (i["w"] // 4, i["h"] // 4), 0, 0, 360, (255, 0, 0), 2), None),
+    ("fillConvexPoly", True, lambda i, **k: cv.fillConvexPoly(i["canvas"], i["hull_points"], (255, 0, 255)), None),
+    ("fillPoly", True, lambda i, **k: cv.fillPoly(i["canvas"], i["points"], (255, 255, 0)), None),
+    ("line", True, lambda i, **k: cv.line(i["canvas"], (0, 0), (i["w"] - 1, i["h"] - 1), (255, 0, 0), 2), None),
+    ("putText", True, lambda i, **k: cv.putText(i["canvas"], "SparkFun", (10, i["h"] // 2), cv.FONT_HERSHEY_SIMPLEX, 1, (255, 255, 255), 2), None),
+    ("rectangle", True, lambda i, **k: cv.rectangle(i["canvas"], (10, 10), (i["w"] // 2, i["h"] // 2), (0, 255, 255), 2), None),
+
+    # imgproc, structural analysis and shape descriptors
+    ("approxPolyDP", False, lambda i, **k: cv.approxPolyDP(i["points"], 2.0, True), None),
+    ("approxPolyN", False, lambda i, **k: cv.approxPolyN(i["hull_points"], 4), None),
+    ("arcLength", False, lambda i, **k: cv.arcLength(i["points"], True), None),
+    ("boundingRect", False, lambda i, **k: cv.boundingRect(i["points"]), None),
+    ("boxPoints", False, lambda i, **k: cv.boxPoints(((80, 60), (40, 20), 30)), None),
+    ("connectedComponents", True, lambda i, **k: cv.connectedComponents(i["gray"], **k), _dst("labels", 1)),
+    ("connectedComponentsStats", True, lambda i, **k: cv.connectedComponentsStats(i["gray"]), None),
+    ("connectedComponentsWithStats", True, lambda i, **k: cv.connectedComponentsWithStats(i["gray"], **k), lambda r: {"labels": r[1], "stats": r[2], "centroids": r[3]}),
+    ("contourArea", False, lambda i, **k: cv.contourArea(i["points"]), None),
+    ("convexHull", False, lambda i, **k: cv.convexHull(i["points"]), None),
+    ("convexityDefects", False, lambda i, **k: cv.convexityDefects(i["points"], i["hull_indices"]), None),
+    ("detectColorBlobs", True, lambda i, **k: cv.detectColorBlobs(i["bgr"], (0, 100, 100), (10, 255, 255), min_area=20), None),
+    ("findContours", True, lambda i, **k: cv.findContours(i["gray"], cv.RETR_EXTERNAL, cv.CHAIN_APPROX_SIMPLE), None),
+    ("fitEllipse", False, lambda i, **k: cv.fitEllipse(i["points"]), None),
+    ("fitLine", False, lambda i, **k: cv.fitLine(i["points"], cv.DIST_L2, 0, 0.01, 0.01), None),
+    ("isContourConvex", False, lambda i, **k: cv.isContourConvex(i["points"]), None),
+    ("matchShapes", False, lambda i, **k: cv.matchShapes(i["points"], i["hull_points"], cv.CONTOURS_MATCH_I1, 0), None),
+    ("minAreaRect", False, lambda i, **k: cv.minAreaRect(i["points"]), None),
+    ("minEnclosingCircle", False, lambda i, **k: cv.minEnclosingCircle(i["points"]), None),
+    ("minEnclosingTriangle", False, lambda i, **k: cv.minEnclosingTriangle(i["points"]), None),
+    ("moments", True, lambda i, **k: cv.moments(i["gray"]), None),
+    ("pointPolygonTest", False, lambda i, **k: cv.pointPolygonTest(i["points"], (80, 60), True), None),
+
+    # imgproc, feature detection
+    ("Canny", True, lambda i, **k: cv.Canny(i["gray"], 100, 200, **k), _dst("edges")),
+    ("HoughCircles", True, lambda i, **k: cv.HoughCircles(i["gray"], cv.HOUGH_GRADIENT, 1, i["h"] / 4, param1=200, param2=30), None),
+    ("HoughCirclesWithAccumulator", True, lambda i, **k: cv.HoughCirclesWithAccumulator(i["gray"], cv.HOUGH_GRADIENT, 1, i["h"] / 4, param1=200, param2=30), None),
+    ("HoughLines", True, lambda i, **k: cv.HoughLines(i["edges"], 1, math.pi / 180, 80), None),
+    ("HoughLinesP", True, lambda i, **k: cv.HoughLinesP(i["edges"], 1, math.pi / 180, 50, minLineLength=20, maxLineGap=5), None),
+    ("HoughLinesWithAccumulator", True, lambda i, **k: cv.HoughLinesWithAccumulator(i["edges"], 1, math.pi / 180, 80), None),
+
+    # imgproc, object detection
+    ("matchTemplate", True, lambda i, **k: cv.matchTemplate(i["gray"], i["templ"], cv.TM_CCOEFF_NORMED, **k), _dst("result")),
+
+    # Bound operations. Compare with threshold() with a preallocated dst
+    ("bind", True, lambda i, **k: i["bound_threshold"](i["gray"]), None),
+
+    # Run-length encoded masks. Compare with threshold(), inRange(), moments()
+    # and connectedComponentsStats() on dense masks
+    ("RLEMask", True, lambda i, **k: cv.RLEMask(i["edges"]), None),
+    ("thresholdRLE", True, lambda i, **k: cv.thresholdRLE(i["gray"], 127), None),
+    ("inRangeRLE", True, lambda i, **k: cv.inRangeRLE(i["bgr"], (0, 0, 100), (100, 100, 255)), None),
+    ("RLEMask.moments", True, lambda i, **k: i["rle"].moments(), None),
+    ("RLEMask.connectedComponentsStats", True, lambda i, **k: i["rle"].connectedComponentsStats(), None),
+
+    # Bit-packed masks. Compare with threshold(), inRange(), erode() and
+    # morphologyEx() on uint8 masks
+    ("BitMask", True, lambda i, **k: cv.BitMask(i["edges"]), None),
+    ("thresholdBits", True, lambda i, **k: cv.thresholdBits(i["gray"], 127, **k), lambda r: {"dst": r[1]}),
+    ("inRangeBits", True, lambda i, **k: cv.inRangeBits(i["bgr"], (0, 0, 100), (100, 100, 255), **k), _dst("dst")),
+    ("BitMask.erode", True, lambda i, **k: i["bits"].erode(i["kernel"], **k), _dst("dst")),
+    ("BitMask.morphologyEx", True, lambda i, **k: i["bits"].morphologyEx(cv.MORPH_OPEN, i["kernel"], **k), _dst("dst")),
+    ("BitMask.bitwise_and", True, lambda i, **k: i["bits"].bitwise_and(i["bits"], **k), _dst("dst")),
+    ("BitMask.countNonZero", True, lambda i, **k: i["bits"].countNonZero(), None),
+    ("BitMask.toArray", True, lambda i, **k: i["bits"].toArray(**k), _dst("dst")),
+
+    # Color classification. Compare with cvtColor() and inRange() once per color
+    ("ColorClassifier", False, lambda i, **k: cv.ColorClassifier(i["color_ranges"]), None),
+    ("ColorClassifier.apply", True, lambda i, **k: i["classifier"].apply(i["bgr"], **k), _dst("dst")),
+
+    # Pipelines. Color blob detection from a BGR frame to packed contours
+    ("Pipeline", True, lambda i, **k: i["pipeline"].run(i["bgr"]), None),
+    ("Pipeline_strips", True, lambda i, **k: i["pipeline_strips"].run(i["bgr"]), None),
+)
+
+# Creates a gray test image with a few shapes, so edge and contour based
+# functions have something to find
+def make_gray(w, h):
+    img = np.zeros((h, w), dtype=np.uint8)
+    cv.rectangle(img, (w // 8, h // 8), (w * 3 // 8, h * 3 // 8), 255, cv.FILLED)
+    cv.circle(img, (w * 5 // 8, h // 2), h // 5, 160, cv.FILLED)
+    cv.line(img, (0, h - 1), (w - 1, 0), 90, 2)
+    return img
+
+# Creates a BGR test image with the same shapes as make_gray()
+def make_bgr(w, h):
+    img = np.zeros((h, w, 3), dtype=np.uint8)
+    cv.rectangle(img, (w // 8, h // 8), (w * 3 // 8, h * 3 // 8), (255, 0, 0), cv.FILLED)
+    cv.circle(img, (w * 5 // 8, h // 2), h // 5, (0, 0, 255), cv.FILLED)
+    cv.line(img, (0, h - 1), (w - 1, 0), (0, 255, 0), 2)
+    return img
+
+# Creates a star shaped contour, which is deliberately not convex
+def make_points(n=64):
+    points = np.zeros((n, 2), dtype=np.float)
+    for j in range(n):
+        a = 2 * math.pi * j / n
+        r = 40 + 10 * (j % 4)
+        points[j, 0] = 80 + r * math.cos(a)
+        points[j, 1] = 60 + r * math.sin(a)
+    return points
+
+# Creates a pipeline that finds red blobs in a BGR image. The opening is done
+# with erode() and dilate(), so the same pipeline can also run on strips
+def make_pipeline(strip_rows=0):
+    kernel = cv.getStructuringElement(cv.MORPH_RECT, (3, 3))
+    return cv.Pipeline([
+        (cv.cvtColor, {"code": cv.COLOR_BGR2HSV}),
+        (cv.GaussianBlur, {"ksize": (5, 5), "sigmaX": 0}),
+        (cv.inRange, {"lower": (0, 100, 100), "upper": (10, 255, 255)}),
+        (cv.erode, {"kernel": kernel}),
+        (cv.dilate, {"kernel": kernel}),
+        (cv.findContours, {"mode": cv.RETR_EXTERNAL, "method": cv.CHAIN_APPROX_SIMPLE, "packed": True}),
+    ], strip_rows=strip_rows)
+
+# Creates all inputs used by the benchmark specifications for one image size
+def make_inputs(w, h, points):
+    gray = make_gray(w, h)
+    inputs = {
+        "w": w,
+        "h": h,
+        "gray": gray,
+        "bgr": make_bgr(w, h),
+        "canvas": np.zeros((h, w, 3), dtype=np.uint8),
+        "frame565": bytearray(w * h * 2),
+        "edges": cv.Canny(gray, 100, 200),
+        "templ": gray[h // 8 : h // 4, w // 8 : w // 4].copy(),
+        "kernel": cv.getStructuringElement(cv.MORPH_RECT, (3, 3)),
+        "sharpen": np.array([[0, -1, 0], [-1, 5, -1], [0, -1, 0]], dtype=np.float),
+        "contours": cv.findContours(gray, cv.RETR_EXTERNAL, cv.CHAIN_APPROX_SIMPLE)[0],
+        "bound_threshold": cv.bind(cv.threshold, thresh=127, maxval=255, type=cv.THRESH_BINARY, dst=np.zeros((h, w), dtype=np.uint8)),
+        "rle": cv.thresholdRLE(gray, 127)[1],
+        "bits": cv.thresholdBits(gray, 127)[1],
+        "classifier": cv.ColorClassifier(points["color_ranges"]),
+        "pipeline": make_pipeline(),
+        "pipeline_strips": make_pipeline(strip_rows=16),
+    }
+    inputs.update(points)
+    return inputs
+
+# Creates the point set and other inputs, which do not depend on the image size
+def make_point_inputs():
+    points = make_points()
+    return {
+        "points": points,
+        "hull_points": cv.convexHull(points),
+        "hull_indices": cv.convexHull(points, returnPoints=False),
+        "color_ranges": [
+            ((0, 100, 100), (10, 255, 255)),
+            ((35, 100, 100), (85, 255, 255)),
+            ((100, 100, 100), (130, 255, 255)),
+        ],
+    }
+
+# Returns the value at the given percentile of a sorted list, using the nearest
+# rank method
+def percentile(values, p):
+    rank = math.ceil(p / 100 * len(values))
+    return values[max(rank, 1) - 1]
+
+# Times one function call repeatedly, and returns a dictionary of statistics
+def measure(call, inputs, kwargs, repeat):
+    times = []
+    alloc_count = 0
+    alloc_bytes = 0
+    heap_bytes = 0
+    for _ in range(repeat):
+        # Collect garbage first, so a collection does not happen during the
+        # timed call and the heap growth can be measured
+        gc.collect()
+        a0 = cv.alloc_stats()
+        m0 = gc.mem_alloc()
+        t0 = time.ticks_us()
+        call(inputs, **kwargs)
+        t1 = time.ticks_us()
+        m1 = gc.mem_alloc()
+        a1 = cv.alloc_stats()
+        times.append(time.ticks_diff(t1, t0))
+        alloc_count += a1[0] - a0[0]
+        alloc_bytes += a1[1] - a0[1]
+        heap_bytes += m1 - m0
+    times.sort()
+    n = len(times)
+    return {
+        "min_us": times[0],
+        "median_us": (times[(n - 1) // 2] + times[n // 2]) // 2,
+        "p99_us": percentile(times, 99),
+        "alloc_count": alloc_count // repeat,
+        "alloc_bytes": alloc_bytes // repeat,
+        "heap_bytes": heap_bytes // repeat,
+    }
+
+# Benchmarks one specification on one set of inputs, with and without a
+# preallocated output array
+def bench_case(spec, case, inputs, repeat, log):
+    name, _, call, dst = spec
+    results = []
+    try:
+        # Warm up, and get an output array of the right shape and type
+        warm = call(inputs)
+        variants = [("new", {})]
+        if dst is not None:
+            variants.append(("dst", dst(warm)))
+        del warm
+        for variant, kwargs in variants:
+            result = {"name": name, "case": case, "variant": variant}
+            result.update(measure(call, inputs, kwargs, repeat))
+            results.append(result)
+            log("%s %s %s: %d us" % (name, case, variant, result["median_us"]))
+        return results, None
+    except Exception as e:
+        log("%s %s: %s" % (name, case, e))
+        return results, {"name": name, "case": case, "error": str(e)}
+
+# Returns a key that identifies a result, for comparing against a baseline
+def result_key(result):
+    return "%s/%s/%s" % (result["name"], result["case"], result["variant"])
+
+# Compares the median times of a report against a baseline report. Changes
+# smaller than the tolerance are treated as noise
+def compare(report, baseline, tolerance):
+    previous = {}
+    for result in baseline["results"]:
+        previous[result_key(result)] = result
+    regressions = []
+    improvements = []
+    missing = []
+    for result in report["results"]:
+        key = result_key(result)
+        if key not in previous:
+            missing.append(key)
+            continue
+        old = previous[key]["median_us"]
+        new = result["median_us"]
+        if old <= 0:
+            continue
+        change = (new - old) / old
+        entry = {"key": key, "baseline_us": old, "median_us": new, "change": change}
+        if change > tolerance:
+            regressions.append(entry)
+        elif change < -tolerance:
+            improvements.append(entry)
+    return {
+        "tolerance": tolerance,
+        "regressions": regressions,
+        "improvements": improvements,
+        "not_in_baseline": missing,
+    }
+
+# Runs the benchmark suite, and returns the report as a dictionary
+def run(sizes=SIZES, repeat=REPEAT, only=None, baseline=None, tolerance=TOLERANCE, verbose=True):
+    def log(message):
+        if verbose:
+            print(message, file=sys.stderr)
+
+    specs = [s for s in SPECS if only is None or s[0] in only]
+    names = [s[0] for s in SPECS]
+
+    # Report anything exported by cv2 that is not benchmarked, so functions
+    # added later without a specification are not silently missed
+    skipped = []
+    for name in dir(cv):
+        if name.startswith("_") or not callable(getattr(cv, name)):
+            continue
+        if name in SKIP:
+            skipped.append({"name": name, "reason": SKIP[name]})
+        elif name not in names:
+            skipped.append({"name": name, "reason": "no benchmark specification"})
+
+    results = []
+    errors = []
+    points = make_point_inputs()
+
+    # Point set functions only need to run once
+    inputs = make_inputs(sizes[0][0], sizes[0][1], points)
+    for spec in specs:
+        if not spec[1]:
+            r, e = bench_case(spec, "points%d" % len(points["points"]), inputs, repeat, log)
+            results.extend(r)
+            if e:
+                errors.append(e)
+    del inputs
+
+    for w, h in sizes:
+        inputs = make_inputs(w, h, points)
+        for spec in specs:
+            if spec[1]:
+                r, e = bench_case(spec, "%dx%d" % (w, h), inputs, repeat, log)
+                results.extend(r)
+                if e:
+                    errors.append(e)
+        del inputs
+        gc.collect()
+
+    report = {
+        "platform": sys.platform,
+        "version": sys.version,
+        "repeat": repeat,
+        "results": results,
+        "errors": errors,
+        "skipped": skipped,
+    }
+    if baseline is not None:
+        report["comparison"] = compare(report, baseline, tolerance)
+    return report
+
+# Parses a list of sizes like "160x120,320x240"
+def parse_sizes(text):
+    sizes = []
+    for size in text.split(","):
+        w, h = size.split("x")
+        sizes.append((int(w), int(h)))
+    return sizes
+
+# Command line entry point. Prints the report as JSON, and returns a non-zero
+# exit code if any regressions were found against the baseline
+def main(argv=None):
+    if argv is None:
+        argv = sys.argv[1:]
+    options = {"sizes": SIZES, "repeat": REPEAT, "only": None, "tolerance": TOLERANCE}
+    save = None
+    baseline = None
+    i = 0
+    while i < len(argv):
+        arg = argv[i]
+        value = argv[i + 1] if i + 1 < len(argv) else None
+        if value is None:
+            raise ValueError("missing value for " + arg)
+        if arg == "--sizes":
+            options["sizes"] = parse_sizes(value)
+        elif arg == "--repeat":
+            options["repeat"] = int(value)
+        elif arg == "--only":
+            options["only"] = value.split(",")
+        elif arg == "--tolerance":
+            options["tolerance"] = float(value)
+        elif arg == "--save":
+            save = value
+        elif arg == "--baseline":
+            with open(value) as f:
+                baseline = json.load(f)
+        else:
+            raise ValueError("unknown option " + arg)
+        i += 2
+
+    report = run(baseline=baseline, **options)
+
+    print(json.dumps(report))
+    if save is not None:
+        with open(save, "w") as f:
+            json.dump(report, f)
+
+    if baseline is not None and report["comparison"]["regressions"]:
+        return 1
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
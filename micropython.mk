@@ -0,0 +1,101 @@
+#-------------------------------------------------------------------------------
+# SPDX-License-Identifier: MIT
+# 
+# Copyright (c) 2025 SparkFun Electronics
+#-------------------------------------------------------------------------------
+# micropython.mk
+# 
+# Makefile for the MicroPython port of OpenCV. This is the equivalent of
+# micropython_opencv.cmake for ports that are built with make instead of CMake,
+# such as the unix port. Keep the two files in sync!
+#-------------------------------------------------------------------------------
+
+# Remember our own directory, because USERMOD_DIR gets changed below
+CV2_MOD_DIR := $(USERMOD_DIR)
+
+# Add our source files to the module.
+SRC_USERMOD_C += $(CV2_MOD_DIR)/src/alloc.c
+SRC_USERMOD_C += $(CV2_MOD_DIR)/src/bind.c
+SRC_USERMOD_C += $(CV2_MOD_DIR)/src/opencv_upy.c
+SRC_USERMOD_C += $(CV2_MOD_DIR)/src/bitmask.c
+SRC_USERMOD_C += $(CV2_MOD_DIR)/src/classifier.c
+SRC_USERMOD_C += $(CV2_MOD_DIR)/src/pipeline.c
+SRC_USERMOD_C += $(CV2_MOD_DIR)/src/rle.c
+SRC_USERMOD_C += $(CV2_MOD_DIR)/src/upyhal.c
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/bind.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/bitmask.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/classifier.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/components.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/convert.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/core.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/highgui.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/imgcodecs.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/imgproc.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/numpy.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/parallel.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/pipeline.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/pool.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/profile.cpp
+SRC_USERMOD_CXX += $(CV2_MOD_DIR)/src/rle.cpp
+
+# Add the src directory as an include directory.
+CFLAGS_USERMOD += -I$(CV2_MOD_DIR)/src
+CXXFLAGS_USERMOD += -I$(CV2_MOD_DIR)/src
+
+# OpenCV creates some global variables on the heap before the GC is
+# initialized. Unlike the embedded ports, the unix port uses the system's C
+# heap, so MICROPY_C_HEAP_SIZE does not need to be set here.
+
+# Makes m_tracked_calloc() and m_tracked_free() available. These track pointers
+# in a linked list to ensure the GC does not free them. Needed for some OpenCV
+# functions
+CFLAGS_USERMOD += -DMICROPY_TRACKED_ALLOC=1
+
+# Per-function profiling counters for cv2.profile(). These time every call, so
+# they're off by default. Enable with MICROPY_PY_CV2_PROFILE=1 on the make
+# command line
+ifeq ($(MICROPY_PY_CV2_PROFILE),1)
+CFLAGS_USERMOD += -DMICROPY_PY_CV2_PROFILE=1
+CXXFLAGS_USERMOD += -DMICROPY_PY_CV2_PROFILE=1
+endif
+
+# Use single precision floats, like the embedded ports. The unix port defaults
+# to double, which would make ulab's float arrays 8 bytes wide, but convert.cpp
+# maps them to CV_32F
+CFLAGS_USERMOD += -DMICROPY_FLOAT_IMPL=MICROPY_FLOAT_IMPL_FLOAT
+CXXFLAGS_USERMOD += -DMICROPY_FLOAT_IMPL=MICROPY_FLOAT_IMPL_FLOAT
+
+# Set ULAB max number of dimensions to 4 (default is 2), which is needed for
+# some OpenCV functions
+CFLAGS_USERMOD += -DULAB_MAX_DIMS=4
+CXXFLAGS_USERMOD += -DULAB_MAX_DIMS=4
+
+# Include ULAB. Its makefile expects USERMOD_DIR to point at its own directory
+USERMOD_DIR := $(CV2_MOD_DIR)/ulab/code
+include $(USERMOD_DIR)/micropython.mk
+USERMOD_DIR := $(CV2_MOD_DIR)
+
+# Include OpenCV. These are the include directories and static libraries that
+# OpenCVConfig.cmake would provide for a build with BUILD_LIST=core,imgproc,imgcodecs
+CV2_OPENCV_DIR := $(CV2_MOD_DIR)/opencv
+CXXFLAGS_USERMOD += -I$(CV2_OPENCV_DIR)/build
+CXXFLAGS_USERMOD += -I$(CV2_OPENCV_DIR)/include
+CXXFLAGS_USERMOD += -I$(CV2_OPENCV_DIR)/modules/core/include
+CXXFLAGS_USERMOD += -I$(CV2_OPENCV_DIR)/modules/imgproc/include
+CXXFLAGS_USERMOD += -I$(CV2_OPENCV_DIR)/modules/imgcodecs/include
+
+# upyhal.c is C, and only needs the HAL interface header
+CFLAGS_USERMOD += -I$(CV2_OPENCV_DIR)/modules/core/include
+LDFLAGS_USERMOD += $(CV2_OPENCV_DIR)/build/lib/libopencv_imgcodecs.a
+LDFLAGS_USERMOD += $(CV2_OPENCV_DIR)/build/lib/libopencv_imgproc.a
+LDFLAGS_USERMOD += $(CV2_OPENCV_DIR)/build/lib/libopencv_core.a
+LDFLAGS_USERMOD += $(CV2_OPENCV_DIR)/build/3rdparty/lib/liblibpng.a
+LDFLAGS_USERMOD += $(CV2_OPENCV_DIR)/build/3rdparty/lib/libzlib.a
+LDFLAGS_USERMOD += -lstdc++ -lpthread -ldl -lm
+
+# Tell the linker to wrap malloc, free, calloc and realloc. These are defined in
+# alloc.c, and ensure OpenCV stuff gets allocated by the garbage collector.
+LDFLAGS_USERMOD += -Wl,--wrap,malloc
+LDFLAGS_USERMOD += -Wl,--wrap,free
+LDFLAGS_USERMOD += -Wl,--wrap,calloc
+LDFLAGS_USERMOD += -Wl,--wrap,realloc
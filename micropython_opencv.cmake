@@ -5,7 +5,9 @@
 #-------------------------------------------------------------------------------
 # opencv_upy.cmake
 # 
-# CMake file for the MicroPython port of OpenCV.
+# CMake file for the MicroPython port of OpenCV. Ports that are built with make
+# instead of CMake (eg. the unix port) use micropython.mk, so keep the two files
+# in sync!
 #-------------------------------------------------------------------------------
 
 # Create an INTERFACE library for our CPP module.
@@ -14,6 +16,13 @@ add_library(usermod_cv2 INTERFACE)
 # Add our source files to the library.
 target_sources(usermod_cv2 INTERFACE
     ${CMAKE_CURRENT_LIST_DIR}/src/alloc.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/bind.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/bind.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/bitmask.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/bitmask.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/classifier.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/classifier.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/components.cpp
     ${CMAKE_CURRENT_LIST_DIR}/src/convert.cpp
     ${CMAKE_CURRENT_LIST_DIR}/src/core.cpp
     ${CMAKE_CURRENT_LIST_DIR}/src/highgui.cpp
@@ -21,6 +30,14 @@ target_sources(usermod_cv2 INTERFACE
     ${CMAKE_CURRENT_LIST_DIR}/src/imgproc.cpp
     ${CMAKE_CURRENT_LIST_DIR}/src/numpy.cpp
     ${CMAKE_CURRENT_LIST_DIR}/src/opencv_upy.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/parallel.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/pipeline.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/pipeline.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/pool.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/profile.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/rle.c
+    ${CMAKE_CURRENT_LIST_DIR}/src/rle.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/upyhal.c
 )
 
 # Add the src directory as an include directory.
@@ -33,14 +50,34 @@ target_link_libraries(usermod INTERFACE usermod_cv2)
 
 # OpenCV creates some global variables on the heap. These get created before
 # the GC is initialized, so we need to allocate some space for them on the C
-# heap. 64kB seems sufficient.
-set(MICROPY_C_HEAP_SIZE 65536)
+# heap. 64kB seems sufficient. The second core can't use the GC either, so the
+# temporary buffers it allocates while running OpenCV also come from the C
+# heap, which needs another 64kB.
+set(MICROPY_C_HEAP_SIZE 131072)
 
 # Makes m_tracked_calloc() and m_tracked_free() available. These track pointers
 # in a linked list to ensure the GC does not free them. Needed for some OpenCV
 # functions
 set(MICROPY_TRACKED_ALLOC 1)
 
+# Per-function profiling counters for cv2.profile(). These time every call, so
+# they're off by default. Enable with -DMICROPY_PY_CV2_PROFILE=1 in CMAKE_ARGS
+if(MICROPY_PY_CV2_PROFILE)
+    target_compile_definitions(usermod INTERFACE MICROPY_PY_CV2_PROFILE=1)
+endif()
+
+# Size of the fast region reserved in SRAM for small, frequently used buffers
+# (see alloc.c), so they don't end up in PSRAM with the frames. Override with
+# -DCV2_FAST_REGION_SIZE=<bytes> in CMAKE_ARGS, or 0 to disable it
+if(NOT DEFINED CV2_FAST_REGION_SIZE)
+    if(PICO_PLATFORM MATCHES "^rp2350")
+        set(CV2_FAST_REGION_SIZE 32768)
+    else()
+        set(CV2_FAST_REGION_SIZE 0)
+    endif()
+endif()
+target_compile_definitions(usermod INTERFACE CV2_FAST_REGION_SIZE=${CV2_FAST_REGION_SIZE})
+
 # Set ULAB max number of dimensions to 4 (default is 2), which is needed for
 # some OpenCV functions
 target_compile_definitions(usermod INTERFACE ULAB_MAX_DIMS=4)
@@ -54,6 +91,15 @@ find_package(OpenCV REQUIRED)
 target_include_directories(usermod INTERFACE ${OpenCV_INCLUDE_DIRS})
 target_link_libraries(usermod INTERFACE ${OpenCV_LIBS})
 
+# OpenCV was built with a custom CV_XADD for the RP2350 (see
+# rp2350.toolchain.cmake). Our code copies Mats too, so it needs to use the same
+# CV_XADD, otherwise reference counters in PSRAM would hang the board
+if(PICO_PLATFORM MATCHES "^rp2350")
+    target_compile_definitions(usermod INTERFACE
+        OPENCV_INCLUDE_PORT_FILE="${CMAKE_CURRENT_LIST_DIR}/platforms/include/rp2350_cv_xadd.h"
+    )
+endif()
+
 # Tell the linker to wrap malloc, free, calloc and realloc. These are defined in
 # alloc.cpp, and ensure OpenCV stuff gets allocated by the garbage collector.
 target_link_libraries(usermod INTERFACE "-Wl,--wrap,malloc")
@@ -0,0 +1,43 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * rp2350_cv_xadd.h
+ * 
+ * Fix for https://github.com/raspberrypi/pico-sdk/issues/2505
+ * TLDR; OpenCV uses atomic operations for incrementing reference counters by
+ * default. However, the Pico SDK does not support atomic operations on data in
+ * PSRAM; attempting to do so just causes an infinite loop where the value is
+ * incremented forever. The workaround is to re-define the `CV_XADD` macro so
+ * the reference counter is updated with normal loads and stores, protected by
+ * a spinlock that lives in SRAM, where atomic operations do work. The lock is
+ * needed because OpenCV runs on both cores (see src/parallel.cpp). Also see:
+ * https://github.com/opencv/opencv/blob/52bed3cd7890192700b2451e2713c340209ffd79/modules/core/include/opencv2/core/cvdef.h#L697-L723
+ *------------------------------------------------------------------------------
+ */
+
+#ifndef RP2350_CV_XADD_H
+#define RP2350_CV_XADD_H
+
+// The lock shared by every CV_XADD. Global variables are placed in SRAM. It's
+// weak so every file that includes this header (OpenCV itself and the cv2
+// module) ends up sharing a single lock
+__attribute__((weak)) char rp2350_cv_xadd_lock = 0;
+
+// Same as OpenCV's unsafe XADD implementation, but inside the lock:
+// https://github.com/opencv/opencv/blob/52bed3cd7890192700b2451e2713c340209ffd79/modules/core/include/opencv2/core/cvdef.h#L719
+static inline int rp2350_cv_xadd(int* addr, int delta)
+{
+    while(__atomic_test_and_set(&rp2350_cv_xadd_lock, __ATOMIC_ACQUIRE)) {}
+    int tmp = *(volatile int*)addr;
+    *(volatile int*)addr = tmp + delta;
+    __atomic_clear(&rp2350_cv_xadd_lock, __ATOMIC_RELEASE);
+    return tmp;
+}
+
+// Define CV_XADD to use our version
+#define CV_XADD(addr, delta) rp2350_cv_xadd(addr, delta)
+
+#endif
@@ -0,0 +1,22 @@
+# Linux host build, used with the MicroPython unix port. This exists so OpenCV
+# and the cv2 module can be profiled and debugged on a workstation (eg. with
+# perf or valgrind) before flashing hardware, so it deliberately stays as close
+# to the embedded platforms as possible.
+
+# Include the common embedded OpenCV settings
+include("${CMAKE_CURRENT_LIST_DIR}/common.cmake")
+
+# Set Linux specific settings
+#
+# Thread support is disabled to match the embedded platforms, so the same code
+# paths are used when profiling
+set(OPENCV_DISABLE_THREAD_SUPPORT ON)
+
+# The MicroPython unix port is linked as a position independent executable by
+# most distributions, so the static OpenCV libraries need to be built as PIC
+set(CMAKE_POSITION_INDEPENDENT_CODE ON)
+
+# Keep debug symbols and frame pointers so perf and valgrind can produce useful
+# call stacks. This does not change the optimization level
+set(CMAKE_C_FLAGS_INIT "${CMAKE_C_FLAGS_INIT} -g -fno-omit-frame-pointer")
+set(CMAKE_CXX_FLAGS_INIT "${CMAKE_CXX_FLAGS_INIT} -g -fno-omit-frame-pointer")
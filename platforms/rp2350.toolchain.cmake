@@ -10,11 +10,15 @@ include("$ENV{PICO_SDK_PATH}/cmake/preload/toolchains/pico_arm_cortex_m33_gcc.cm
 include("${CMAKE_CURRENT_LIST_DIR}/common.cmake")
 
 # Set RP2350 specific settings
+#
+# OpenCV's threading frameworks need an OS, so thread support stays disabled.
+# parallel_for_() still uses both cores through the custom backend registered
+# by the cv2 module, see src/parallel.cpp
 set(OPENCV_DISABLE_THREAD_SUPPORT ON)
 
 # Fix for https://github.com/raspberrypi/pico-sdk/issues/2505
-set(CMAKE_C_FLAGS_INIT "${CMAKE_C_FLAGS_INIT} -DOPENCV_INCLUDE_PORT_FILE=\\\"${CMAKE_CURRENT_LIST_DIR}/include/rp2350_unsafe_cv_xadd.h\\\"")
-set(CMAKE_CXX_FLAGS_INIT "${CMAKE_CXX_FLAGS_INIT} -DOPENCV_INCLUDE_PORT_FILE=\\\"${CMAKE_CURRENT_LIST_DIR}/include/rp2350_unsafe_cv_xadd.h\\\"")
+set(CMAKE_C_FLAGS_INIT "${CMAKE_C_FLAGS_INIT} -DOPENCV_INCLUDE_PORT_FILE=\\\"${CMAKE_CURRENT_LIST_DIR}/include/rp2350_cv_xadd.h\\\"")
+set(CMAKE_CXX_FLAGS_INIT "${CMAKE_CXX_FLAGS_INIT} -DOPENCV_INCLUDE_PORT_FILE=\\\"${CMAKE_CURRENT_LIST_DIR}/include/rp2350_cv_xadd.h\\\"")
 
 # Fix for https://github.com/sparkfun/micropython-opencv/issues/31
 # Source: https://docs.zephyrproject.org/4.0.0/doxygen/html/zephyr__stdint_8h_source.html
@@ -0,0 +1,19 @@
+#-------------------------------------------------------------------------------
+# SPDX-License-Identifier: MIT
+# 
+# Copyright (c) 2025 SparkFun Electronics
+#-------------------------------------------------------------------------------
+# upyhalConfig.cmake
+# 
+# Package configuration for our OpenCV HAL, found by OpenCV when it's configured
+# with -DOpenCV_HAL=upyhal (see the Makefile). OpenCV includes the header in
+# place of its default `cv_hal_*` hooks. The functions themselves are compiled
+# as part of the cv2 module (src/upyhal.c), so there is no library to link, and
+# they get resolved when the firmware is linked.
+#-------------------------------------------------------------------------------
+
+set(upyhal_FOUND TRUE)
+set(upyhal_VERSION 1.0.0)
+set(upyhal_LIBRARIES "")
+set(upyhal_HEADERS "${CMAKE_CURRENT_LIST_DIR}/../../src/upyhal.h")
+set(upyhal_INCLUDE_DIRS "")
@@ -8,12 +8,14 @@
  * 
  * Wrapper functions for malloc(), free(), calloc(), and realloc(). These ensure
  * memory gets allocated on the C heap before the MicroPython garbage collector
- * has been initialized, and and in the GC pool afterwards.
+ * has been initialized, and and in the GC pool afterwards. Small blocks come
+ * from a scratch arena, which prefers a fast region (eg. SRAM) when one is set.
  *------------------------------------------------------------------------------
  */
 
 // C headers
 #include "py/runtime.h"
+#include "py/gc.h"
 
 // Hacky solution to see if the GC is initialized. If so, we can use gc_alloc
 // and gc_free. Otherwise, we need to use __real_malloc and __real_free.
@@ -24,6 +26,24 @@ bool gc_inited() {
     return MP_STATE_MEM(area).gc_pool_start != NULL;
 }
 
+// Checks whether a pointer lies inside the GC pool. Memory allocated before the
+// GC was initialized (or by code that is not wrapped, like the C library itself
+// on the unix port) lives on the C heap, and must be given back to the C heap
+// even if it gets freed after the GC has been initialized.
+bool gc_owns(const void *ptr) {
+    #if MICROPY_GC_SPLIT_HEAP
+    for(mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = area->next) {
+        if((const byte *)ptr >= area->gc_pool_start && (const byte *)ptr < area->gc_pool_end) {
+            return true;
+        }
+    }
+    return false;
+    #else
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    return (const byte *)ptr >= area->gc_pool_start && (const byte *)ptr < area->gc_pool_end;
+    #endif
+}
+
 // Since the linker flag `-Wl,--wrap=malloc` (and calloc, realloc, and free) is
 // set, calls to `malloc()` get replaced with `__wrap_malloc()` by the linker.
 // To use the original `malloc()`, we can instead use `__real_malloc()`, which
@@ -34,46 +54,658 @@ extern void *__real_calloc(size_t count, size_t size);
 extern void *__real_realloc(void *mem, size_t size);
 extern void *__real_free(void *mem);
 
+// Running totals of allocations made in the GC heap through the wrappers below.
+// These are never reset, so callers should measure the difference before and
+// after the code they are interested in.
+static size_t alloc_count = 0;
+static size_t alloc_bytes = 0;
+
+// Returns the running totals as a tuple of (count, bytes).
+mp_obj_t cv2_alloc_stats(void) {
+    mp_obj_t stats[2];
+    stats[0] = mp_obj_new_int_from_uint(alloc_count);
+    stats[1] = mp_obj_new_int_from_uint(alloc_bytes);
+    return mp_obj_new_tuple(2, stats);
+}
+
+// Returns the running totals without creating any objects, for the profiling
+// counters in profile.cpp.
+void alloc_get_stats(size_t *count, size_t *bytes) {
+    *count = alloc_count;
+    *bytes = alloc_bytes;
+}
+
+// Blocks from m_tracked_calloc() are preceded by a node of the tracked list,
+// which is a pair of pointers when the GC is enabled (see py/malloc.c). The GC
+// block itself starts at the node.
+#define TRACKED_NODE_SIZE (2 * sizeof(void *))
+
+// Returns true when called from the worker that runs OpenCV parallel regions
+// on the other core (or thread), see parallel.cpp. The GC must not be used from
+// the worker, so it gets memory from the C heap instead.
+extern bool cv2_parallel_in_worker(void);
+
+// Set by parallel.cpp while the worker is running. Neither the GC nor the C
+// heap can be used from two cores at once, so the wrappers below are serialized
+// with a spinlock during that time. The lock is in SRAM, where atomic
+// operations work on the RP2350.
+//
+// The core holding the lock can take it again. A GC allocation made with the
+// lock held can trigger a collection, and the finalisers it runs (eg. the one
+// convert.cpp uses to release a Mat) free memory through the same wrappers.
+static volatile bool alloc_parallel = false;
+static char alloc_spinlock = 0;
+static volatile int alloc_owner = -1;
+static int alloc_depth = 0;
+
+// GC blocks freed by the worker. These get freed by the caller once the worker
+// is done, and are linked through their first word while they wait.
+static void *alloc_deferred = NULL;
+
+static bool alloc_lock(void) {
+    if(!alloc_parallel) {
+        return false;
+    }
+    // Only the owner ever sets alloc_owner to its own number, so the other
+    // core can't mistake the lock for its own
+    int self = cv2_parallel_in_worker() ? 1 : 0;
+    if(alloc_owner == self) {
+        alloc_depth++;
+        return true;
+    }
+    while(__atomic_test_and_set(&alloc_spinlock, __ATOMIC_ACQUIRE)) {
+    }
+    alloc_owner = self;
+    alloc_depth = 1;
+    return true;
+}
+static void alloc_unlock(bool locked) {
+    if(locked && --alloc_depth == 0) {
+        alloc_owner = -1;
+        __atomic_clear(&alloc_spinlock, __ATOMIC_RELEASE);
+    }
+}
+
+static void arena_trim(void);
+
+void alloc_set_parallel(bool parallel) {
+    alloc_parallel = parallel;
+    if(!parallel) {
+        while(alloc_deferred != NULL) {
+            void *ptr = alloc_deferred;
+            alloc_deferred = *(void **)ptr;
+            m_tracked_free(ptr);
+        }
+        arena_trim();
+    }
+}
+
+// Returns true if new allocations should come from the GC heap.
+static bool alloc_use_gc(void) {
+    return gc_inited() && !cv2_parallel_in_worker();
+}
+
+// Gives a GC block back to the GC, or defers that if called from the worker.
+static void alloc_gc_free(void *ptr) {
+    if(cv2_parallel_in_worker()) {
+        *(void **)ptr = alloc_deferred;
+        alloc_deferred = ptr;
+    }
+    else {
+        m_tracked_free(ptr);
+    }
+}
+
+// Objects that call a C function when the GC collects them. Used for the
+// soft reset sentinel below, and by convert.cpp to release the Mat behind an
+// ndarray that wraps its data.
+typedef struct _alloc_finaliser_obj_t {
+    mp_obj_base_t base;
+    void (*fn)(void *arg);
+    void *arg;
+} alloc_finaliser_obj_t;
+
+#if MICROPY_ENABLE_FINALISER
+
+static mp_obj_t alloc_finaliser_del(mp_obj_t self_in) {
+    alloc_finaliser_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if(self->fn != NULL) {
+        self->fn(self->arg);
+        self->fn = NULL;
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(alloc_finaliser_del_obj, alloc_finaliser_del);
+
+static const mp_rom_map_elem_t alloc_finaliser_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&alloc_finaliser_del_obj) },
+};
+static MP_DEFINE_CONST_DICT(alloc_finaliser_locals_dict, alloc_finaliser_locals_dict_table);
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    alloc_finaliser_type,
+    MP_QSTR_finaliser,
+    MP_TYPE_FLAG_NONE,
+    locals_dict, &alloc_finaliser_locals_dict
+    );
+
+// Creates an object that calls fn(arg) when it gets collected, or during a
+// soft reset. Returns NULL if that's not possible. This is called from inside
+// the malloc wrappers, so it can't raise an exception.
+void *alloc_new_finaliser(void (*fn)(void *arg), void *arg) {
+    alloc_finaliser_obj_t *self = gc_alloc(sizeof(alloc_finaliser_obj_t), GC_ALLOC_FLAG_HAS_FINALISER);
+    if(self == NULL) {
+        return NULL;
+    }
+    self->base.type = &alloc_finaliser_type;
+    self->fn = fn;
+    self->arg = arg;
+    return self;
+}
+
+#else
+
+void *alloc_new_finaliser(void (*fn)(void *arg), void *arg) {
+    return NULL;
+}
+
+#endif
+
+// A soft reset frees the whole GC heap, so anything that keeps GC memory
+// across calls (the arena below, and the Mat buffer pool in pool.cpp) must
+// forget about it. gc_sweep_all() runs every finaliser during a soft reset, so
+// a sentinel finaliser takes care of that. The sentinel is rooted, so it's
+// never collected otherwise.
+MP_REGISTER_ROOT_POINTER(void *cv2_alloc_sentinel);
+
+// Defined in pool.cpp
+extern void cv2_pool_forget(void);
+
+static inline void arena_forget(void);
+
+static void alloc_soft_reset(void *arg) {
+    arena_forget();
+    cv2_pool_forget();
+    MP_STATE_VM(cv2_alloc_sentinel) = NULL;
+}
+
+// Creates the sentinel if needed. Returns false if GC memory can't be kept
+// across calls, because the sentinel couldn't be created.
+bool alloc_watch_soft_reset(void) {
+    if(MP_STATE_VM(cv2_alloc_sentinel) == NULL) {
+        MP_STATE_VM(cv2_alloc_sentinel) = alloc_new_finaliser(alloc_soft_reset, NULL);
+    }
+    return MP_STATE_VM(cv2_alloc_sentinel) != NULL;
+}
+
+// Scratch arena for small allocations. Most of what OpenCV allocates is freed
+// again before the wrapper that called it returns (row buffers, temporary Mats,
+// vectors, etc.), so these are bump allocated from chunks of GC memory instead
+// of each being a zeroed, tracked GC block. Each chunk counts its live blocks,
+// and starts over from the beginning once they have all been freed, which is
+// normally when the wrapper returns. If a block outlives the call, its chunk is
+// kept until that block is freed too, and a new chunk takes over.
+//
+// The chunks are rooted through MP_STATE_VM(cv2_arena_chunks), and
+// arena_current is the chunk currently being allocated from.
+//
+// These small blocks (kernel and line buffers, LUTs, histograms) are also the
+// ones inner loops hit hardest, while frames are too big for anything but the
+// GC heap, which is mostly PSRAM on boards that have it. So the arena prefers
+// chunks from a fast region, set with cv2.set_fast_region() or reserved in SRAM
+// at build time with CV2_FAST_REGION_SIZE, and only takes chunks from the GC
+// heap when the fast region is full. The fast region is split into chunks up
+// front, which are found by their address instead of being linked into the
+// rooted list, since they aren't GC blocks. Blocks in the fast region can hold
+// the only reference to a GC object (eg. the ndarray of a Mat's UMatData), so
+// the region must still be scanned by the GC. A region set from Python is part
+// of its buffer object, which is rooted, and the one reserved at build time is
+// a root pointer itself.
+#ifndef CV2_ARENA
+#define CV2_ARENA (MICROPY_ENABLE_FINALISER)
+#endif
+#ifndef CV2_ARENA_CHUNK_SIZE
+#define CV2_ARENA_CHUNK_SIZE (16 * 1024)
+#endif
+#ifndef CV2_ARENA_MAX_BLOCK
+#define CV2_ARENA_MAX_BLOCK (CV2_ARENA_CHUNK_SIZE / 4)
+#endif
+#ifndef CV2_FAST_REGION_SIZE
+#define CV2_FAST_REGION_SIZE (0)
+#endif
+
+typedef struct _arena_chunk_t {
+    struct _arena_chunk_t *next;
+    // Bytes handed out so far, including block headers
+    size_t used;
+    // Blocks that have not been freed yet
+    size_t live;
+} arena_chunk_t;
+
+// Blocks are aligned like glibc and newlib align malloc(). Each block is
+// preceded by its requested size, which is padded to keep the block aligned.
+#define ARENA_ALIGN (2 * sizeof(void *))
+#define ARENA_ROUND(n) (((n) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+#define ARENA_CHUNK_HEADER ARENA_ROUND(sizeof(arena_chunk_t))
+#define ARENA_BLOCK_HEADER ARENA_ALIGN
+#define ARENA_DATA_SIZE (CV2_ARENA_CHUNK_SIZE - ARENA_CHUNK_HEADER)
+
+MP_REGISTER_ROOT_POINTER(void *cv2_arena_chunks);
+
+// The object whose buffer is the fast region, if it was set from Python
+MP_REGISTER_ROOT_POINTER(mp_obj_t cv2_fast_region);
+
+static inline uint8_t *arena_data(arena_chunk_t *chunk) {
+    return (uint8_t *)chunk + ARENA_CHUNK_HEADER;
+}
+
+// Running totals of arena blocks that came from the fast region, like
+// alloc_count and alloc_bytes.
+static size_t fast_count = 0;
+static size_t fast_bytes = 0;
+
+#if CV2_ARENA
+
+static arena_chunk_t *arena_current = NULL;
+
+// The fast region, once fast_init() has run. Chunks are laid out back to back
+// from fast_start.
+static uint8_t *fast_start = NULL;
+static uint8_t *fast_end = NULL;
+static bool fast_inited = false;
+
+// The region reserved at build time. Root pointers are only aligned to a
+// pointer, so there's an extra one to leave room for aligning the chunks
+#if CV2_FAST_REGION_SIZE > 0
+MP_REGISTER_ROOT_POINTER(void *cv2_fast_static[CV2_FAST_REGION_SIZE / sizeof(void *) + 1]);
+#endif
+
+static inline bool fast_owns(const void *ptr) {
+    return (const uint8_t *)ptr >= fast_start && (const uint8_t *)ptr < fast_end;
+}
+
+// Splits size bytes at start into empty chunks, and makes them the fast
+// region. Returns false if there isn't room for a single chunk.
+static bool fast_set(uint8_t *start, size_t size) {
+    uint8_t *aligned = (uint8_t *)ARENA_ROUND((uintptr_t)start);
+    size_t pad = aligned - start;
+    size_t n_chunks = size > pad ? (size - pad) / CV2_ARENA_CHUNK_SIZE : 0;
+    fast_inited = true;
+    if(n_chunks == 0) {
+        fast_start = fast_end = NULL;
+        return false;
+    }
+    fast_start = aligned;
+    fast_end = aligned + n_chunks * CV2_ARENA_CHUNK_SIZE;
+    for(uint8_t *ptr = fast_start; ptr < fast_end; ptr += CV2_ARENA_CHUNK_SIZE) {
+        arena_chunk_t *chunk = (arena_chunk_t *)ptr;
+        chunk->next = NULL;
+        chunk->used = 0;
+        chunk->live = 0;
+    }
+    return true;
+}
+
+// Starts with the region reserved at build time, if there is one.
+static void fast_init(void) {
+    if(fast_inited) {
+        return;
+    }
+    #if CV2_FAST_REGION_SIZE > 0
+    // The arena forgets the region during a soft reset, which resets the chunks
+    if(alloc_watch_soft_reset()) {
+        fast_set((uint8_t *)MP_STATE_VM(cv2_fast_static), sizeof(MP_STATE_VM(cv2_fast_static)));
+        return;
+    }
+    #endif
+    fast_set(NULL, 0);
+}
+
+// Returns an empty chunk of the fast region, or NULL if there are none.
+static arena_chunk_t *fast_empty_chunk(void) {
+    fast_init();
+    for(uint8_t *ptr = fast_start; ptr < fast_end; ptr += CV2_ARENA_CHUNK_SIZE) {
+        arena_chunk_t *chunk = (arena_chunk_t *)ptr;
+        if(chunk->live == 0 && chunk != arena_current) {
+            return chunk;
+        }
+    }
+    return NULL;
+}
+
+static inline void arena_forget(void) {
+    MP_STATE_VM(cv2_arena_chunks) = NULL;
+    MP_STATE_VM(cv2_fast_region) = MP_OBJ_NULL;
+    arena_current = NULL;
+    fast_start = fast_end = NULL;
+    fast_inited = false;
+}
+
+// Returns the chunk that contains ptr, or NULL if it's not an arena block.
+static arena_chunk_t *arena_find(const void *ptr) {
+    if(fast_owns(ptr)) {
+        size_t offset = (const uint8_t *)ptr - fast_start;
+        arena_chunk_t *chunk = (arena_chunk_t *)(fast_start + offset - offset % CV2_ARENA_CHUNK_SIZE);
+        return (const uint8_t *)ptr >= arena_data(chunk) ? chunk : NULL;
+    }
+    for(arena_chunk_t *chunk = MP_STATE_VM(cv2_arena_chunks); chunk != NULL; chunk = chunk->next) {
+        if((const uint8_t *)ptr >= arena_data(chunk) && (const uint8_t *)ptr < arena_data(chunk) + ARENA_DATA_SIZE) {
+            return chunk;
+        }
+    }
+    return NULL;
+}
+
+// Makes an empty chunk the current one. Chunks from the fast region come
+// first, then empty GC chunks get reused before allocating a new one.
+static arena_chunk_t *arena_next_chunk(void) {
+    arena_chunk_t *chunk = fast_empty_chunk();
+    if(chunk == NULL) {
+        for(chunk = MP_STATE_VM(cv2_arena_chunks); chunk != NULL; chunk = chunk->next) {
+            if(chunk->live == 0 && chunk != arena_current) {
+                break;
+            }
+        }
+    }
+    if(chunk == NULL) {
+        if(!alloc_watch_soft_reset()) {
+            return NULL;
+        }
+        chunk = m_malloc_maybe(CV2_ARENA_CHUNK_SIZE);
+        if(chunk == NULL) {
+            return NULL;
+        }
+        chunk->next = MP_STATE_VM(cv2_arena_chunks);
+        MP_STATE_VM(cv2_arena_chunks) = chunk;
+    }
+    chunk->used = 0;
+    chunk->live = 0;
+    arena_current = chunk;
+    return chunk;
+}
+
+// Returns NULL if the block should come from the GC heap instead.
+static void *arena_alloc(size_t size) {
+    if(size > CV2_ARENA_MAX_BLOCK) {
+        return NULL;
+    }
+    size_t need = ARENA_BLOCK_HEADER + ARENA_ROUND(size);
+    arena_chunk_t *chunk = arena_current;
+    if(chunk == NULL || chunk->used + need > ARENA_DATA_SIZE) {
+        chunk = arena_next_chunk();
+        if(chunk == NULL) {
+            return NULL;
+        }
+    }
+    uint8_t *block = arena_data(chunk) + chunk->used;
+    chunk->used += need;
+    chunk->live++;
+    *(size_t *)block = size;
+    if(fast_owns(chunk)) {
+        fast_count++;
+        fast_bytes += size;
+    }
+    return block + ARENA_BLOCK_HEADER;
+}
+
+static size_t arena_block_size(const void *ptr) {
+    return *(const size_t *)((const uint8_t *)ptr - ARENA_BLOCK_HEADER);
+}
+
+// Resizes a block without moving it. Blocks can always shrink, and the last
+// block in a chunk can also grow into the rest of the chunk.
+static bool arena_resize(arena_chunk_t *chunk, void *ptr, size_t size) {
+    uint8_t *block = (uint8_t *)ptr - ARENA_BLOCK_HEADER;
+    size_t offset = block - arena_data(chunk);
+    size_t old_size = *(size_t *)block;
+    bool last = offset + ARENA_BLOCK_HEADER + ARENA_ROUND(old_size) == chunk->used;
+    size_t new_used = offset + ARENA_BLOCK_HEADER + ARENA_ROUND(size);
+    if(size > old_size && (!last || size > CV2_ARENA_MAX_BLOCK || new_used > ARENA_DATA_SIZE)) {
+        return false;
+    }
+    if(last) {
+        chunk->used = new_used;
+    }
+    *(size_t *)block = size;
+    return true;
+}
+
+static void arena_free(arena_chunk_t *chunk) {
+    chunk->live--;
+    if(chunk->live == 0) {
+        chunk->used = 0;
+        // Go back to the fast region once the current GC chunk is empty
+        if(chunk == arena_current && fast_start != NULL && !fast_owns(chunk)) {
+            arena_current = NULL;
+        }
+        // Give spare chunks back to the GC. The worker can't, so arena_trim()
+        // does it once the worker is done
+        if(chunk != arena_current && !cv2_parallel_in_worker()) {
+            arena_trim();
+        }
+    }
+}
+
+// Gives every empty GC chunk except the current one back to the GC.
+static void arena_trim(void) {
+    arena_chunk_t **link = (arena_chunk_t **)&MP_STATE_VM(cv2_arena_chunks);
+    arena_chunk_t *chunk;
+    while((chunk = *link) != NULL) {
+        if(chunk->live == 0 && chunk != arena_current) {
+            *link = chunk->next;
+            m_del(uint8_t, chunk, CV2_ARENA_CHUNK_SIZE);
+        }
+        else {
+            link = &chunk->next;
+        }
+    }
+}
+
+// Makes buffer the fast region, or stops using one if it's None. The chunks of
+// the old region must all be empty, which they are between calls unless
+// something still holds a block from them.
+mp_obj_t cv2_set_fast_region(mp_obj_t buffer) {
+    fast_init();
+    for(uint8_t *ptr = fast_start; ptr < fast_end; ptr += CV2_ARENA_CHUNK_SIZE) {
+        if(((arena_chunk_t *)ptr)->live > 0) {
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("fast region is in use"));
+        }
+    }
+    if(fast_owns(arena_current)) {
+        arena_current = NULL;
+    }
+
+    if(buffer == mp_const_none) {
+        fast_set(NULL, 0);
+        MP_STATE_VM(cv2_fast_region) = MP_OBJ_NULL;
+        return mp_const_none;
+    }
+
+    // The buffer only lives until a soft reset
+    mp_buffer_info_t info;
+    mp_get_buffer_raise(buffer, &info, MP_BUFFER_RW);
+    if(!alloc_watch_soft_reset() || !fast_set(info.buf, info.len)) {
+        fast_set(NULL, 0);
+        MP_STATE_VM(cv2_fast_region) = MP_OBJ_NULL;
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("fast region must be at least %d bytes"), (int)(CV2_ARENA_CHUNK_SIZE + ARENA_ALIGN));
+    }
+    MP_STATE_VM(cv2_fast_region) = buffer;
+    return mp_const_none;
+}
+
+#else
+
+static inline void arena_forget(void) {
+}
+static arena_chunk_t *arena_find(const void *ptr) {
+    return NULL;
+}
+static void *arena_alloc(size_t size) {
+    return NULL;
+}
+static size_t arena_block_size(const void *ptr) {
+    return 0;
+}
+static bool arena_resize(arena_chunk_t *chunk, void *ptr, size_t size) {
+    return false;
+}
+static void arena_free(arena_chunk_t *chunk) {
+}
+static void arena_trim(void) {
+}
+mp_obj_t cv2_set_fast_region(mp_obj_t buffer) {
+    mp_raise_NotImplementedError(MP_ERROR_TEXT("fast region needs the scratch arena"));
+}
+
+#endif
+
+// Returns the running totals of fast region blocks as a tuple of (count, bytes).
+mp_obj_t cv2_fast_stats(void) {
+    mp_obj_t stats[2];
+    stats[0] = mp_obj_new_int_from_uint(fast_count);
+    stats[1] = mp_obj_new_int_from_uint(fast_bytes);
+    return mp_obj_new_tuple(2, stats);
+}
+
 // Implementations of the malloc, calloc, realloc, and free functions. If the
 // GC is initialized, we use the MicroPython functions to use the GC heap.
-// Otherwise, we use the "real" functions to use the C heap.
-void *__wrap_malloc(size_t size) {
-    if(gc_inited()) {
+// Otherwise, we use the "real" functions to use the C heap. Pointers passed to
+// free and realloc are sent back to whichever heap they came from.
+static void *alloc_malloc(size_t size) {
+    if(alloc_use_gc()) {
+        alloc_count++;
+        alloc_bytes += size;
+        void *ptr = arena_alloc(size);
+        if(ptr != NULL) {
+            return ptr;
+        }
         return m_tracked_calloc(1, size);
     }
     else {
         return __real_malloc(size);
     }
 }
-void __wrap_free(void *ptr) {
-    if(gc_inited()) {
-        m_tracked_free(ptr);
+static void alloc_free(void *ptr) {
+    arena_chunk_t *chunk = arena_find(ptr);
+    if(chunk != NULL) {
+        arena_free(chunk);
+    }
+    else if(gc_owns(ptr)) {
+        alloc_gc_free(ptr);
     }
     else {
         __real_free(ptr);
     }
 }
-void *__wrap_calloc(size_t count, size_t size)
+static void *alloc_calloc(size_t count, size_t size)
 {
-    if(gc_inited()) {
+    if(alloc_use_gc()) {
+        alloc_count++;
+        alloc_bytes += count * size;
+        // Arena blocks get reused, so they need to be cleared
+        void *ptr = count <= CV2_ARENA_MAX_BLOCK / (size ? size : 1) ? arena_alloc(count * size) : NULL;
+        if(ptr != NULL) {
+            memset(ptr, 0, count * size);
+            return ptr;
+        }
         return m_tracked_calloc(count, size);
     }
     else {
         return __real_calloc(count, size);
     }
 }
-void *__wrap_realloc(void *ptr, size_t size)
+static void *alloc_realloc(void *ptr, size_t size)
 {
-    if(gc_inited()) {
-        void *new_ptr = m_tracked_calloc(1, size);
+    arena_chunk_t *chunk;
+    if(ptr == NULL) {
+        return alloc_malloc(size);
+    }
+    else if((chunk = arena_find(ptr)) != NULL) {
+        if(arena_resize(chunk, ptr, size)) {
+            return ptr;
+        }
+        void *new_ptr = alloc_malloc(size);
+        if(new_ptr == NULL) {
+            return NULL;
+        }
+        size_t old_size = arena_block_size(ptr);
+        memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+        arena_free(chunk);
+        return new_ptr;
+    }
+    else if(gc_owns(ptr)) {
+        // Try to resize the GC block in place first. The worker can't touch
+        // the GC, but it can still move the block to the C heap
+        void *node = (uint8_t *)ptr - TRACKED_NODE_SIZE;
+        if(!cv2_parallel_in_worker() && gc_realloc(node, TRACKED_NODE_SIZE + size, false) != NULL) {
+            return ptr;
+        }
+        void *new_ptr = alloc_malloc(size);
         if (new_ptr == NULL) {
             return NULL;
         }
-        memcpy(new_ptr, ptr, size);
-        m_tracked_free(ptr);
+        // Only copy what the old block holds. GC blocks are rounded up, so this
+        // can include a few bytes past the old size, but never past the block
+        size_t old_size = gc_nbytes(node) - TRACKED_NODE_SIZE;
+        memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+        alloc_gc_free(ptr);
         return new_ptr;
     }
     else {
         return __real_realloc(ptr, size);
     }
 }
+
+// Allocates like malloc(), but never from the scratch arena. For small blocks
+// that are expected to outlive the call, like the UMatData of a pooled Mat,
+// which convert.cpp can hand to Python along with the Mat's data. Blocks in the
+// arena would keep their whole chunk from being reused until they're freed.
+void *alloc_malloc_outside_arena(size_t size) {
+    bool locked = alloc_lock();
+    void *ptr;
+    if(alloc_use_gc()) {
+        alloc_count++;
+        alloc_bytes += size;
+        ptr = m_tracked_calloc(1, size);
+    }
+    else {
+        ptr = __real_malloc(size);
+    }
+    alloc_unlock(locked);
+    return ptr;
+}
+
+// Returns true if ptr is a block of the scratch arena.
+bool alloc_in_arena(const void *ptr) {
+    bool locked = alloc_lock();
+    bool found = arena_find(ptr) != NULL;
+    alloc_unlock(locked);
+    return found;
+}
+
+// The wrappers themselves, which just take the lock when needed.
+void *__wrap_malloc(size_t size) {
+    bool locked = alloc_lock();
+    void *ptr = alloc_malloc(size);
+    alloc_unlock(locked);
+    return ptr;
+}
+void __wrap_free(void *ptr) {
+    bool locked = alloc_lock();
+    alloc_free(ptr);
+    alloc_unlock(locked);
+}
+void *__wrap_calloc(size_t count, size_t size)
+{
+    bool locked = alloc_lock();
+    void *ptr = alloc_calloc(count, size);
+    alloc_unlock(locked);
+    return ptr;
+}
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    bool locked = alloc_lock();
+    void *new_ptr = alloc_realloc(ptr, size);
+    alloc_unlock(locked);
+    return new_ptr;
+}
@@ -0,0 +1,32 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * alloc.h
+ * 
+ * MicroPython wrappers for the memory allocation statistics kept by alloc.c,
+ * and for the fast region used by its scratch arena.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Function declarations
+extern mp_obj_t cv2_alloc_stats(void);
+extern mp_obj_t cv2_fast_stats(void);
+extern mp_obj_t cv2_set_fast_region(mp_obj_t buffer);
+
+// Python references to the functions
+static MP_DEFINE_CONST_FUN_OBJ_0(cv2_alloc_stats_obj, cv2_alloc_stats);
+static MP_DEFINE_CONST_FUN_OBJ_0(cv2_fast_stats_obj, cv2_fast_stats);
+static MP_DEFINE_CONST_FUN_OBJ_1(cv2_set_fast_region_obj, cv2_set_fast_region);
+
+// Global definitions for functions and constants
+#define OPENCV_ALLOC_GLOBALS \
+    /* Functions */ \
+    { MP_ROM_QSTR(MP_QSTR_alloc_stats), MP_ROM_PTR(&cv2_alloc_stats_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_fast_stats), MP_ROM_PTR(&cv2_fast_stats_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_set_fast_region), MP_ROM_PTR(&cv2_set_fast_region_obj) }
@@ -0,0 +1,26 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * bind.c
+ * 
+ * Type of the objects returned by cv2.bind(). The type is defined in C, since
+ * MicroPython's type macros don't compile as C++. Everything else is in
+ * bind.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Defined in bind.cpp
+extern mp_obj_t cv2_bind_bound_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    cv2_bound_type,
+    MP_QSTR_bound,
+    MP_TYPE_FLAG_NONE,
+    call, cv2_bind_bound_call
+    );
@@ -0,0 +1,496 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * bind.cpp
+ * 
+ * Bound operations. cv2.bind(fn, **kwargs) parses and converts every argument
+ * except src once, and returns a callable that only converts src on each call.
+ * For small images the argument parsing and conversion in the wrappers is a
+ * measurable fraction of the runtime, and a loop usually calls the same
+ * function with the same arguments every frame.
+ * 
+ * Arrays bound as arguments (eg. dst, or the kernel of erode()) are kept as Mat
+ * headers over the ndarray's data (see ndarray_to_mat_header()), so neither
+ * binding nor calling allocates anything for them.
+ * 
+ * Bound operations are also the stages of a cv2.Pipeline, see pipeline.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+#include "bound.h"
+#include "convert.h"
+#include "numpy.h"
+#include "ops.h"
+#include "parallel.h"
+#include "profile_scope.h"
+#include <new>
+
+// C headers
+extern "C" {
+#include "bind.h"
+#include "core.h"
+#include "imgproc.h"
+#include "ndarray.h"
+// Defined in bind.c
+extern const mp_obj_type_t cv2_bound_type;
+} // extern "C"
+
+using namespace cv;
+
+// Largest number of arguments of any BoundOp
+#define BIND_MAX_ARGS 7
+
+// Binds dst. ndarrays that aren't dense can't be used through a header, so
+// those are converted on each call instead
+static void bind_dst(cv2_bound_obj_t* self, mp_obj_t obj)
+{
+    if(obj == mp_const_none)
+    {
+        self->dst_obj = mp_const_none;
+        return;
+    }
+    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
+    self->dst_obj = MP_OBJ_FROM_PTR(ndarray);
+    self->dst = ndarray_to_mat_header(ndarray);
+}
+
+// Binds an input array. These are only read, so ndarrays that aren't dense are
+// copied once
+static void bind_mat(cv2_bound_obj_t* self, int i, mp_obj_t obj)
+{
+    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
+    if(!ndarray_is_dense(ndarray))
+        ndarray = (ndarray_obj_t*) MP_OBJ_TO_PTR(ndarray_copy(MP_OBJ_FROM_PTR(ndarray)));
+    self->objs[i] = MP_OBJ_FROM_PTR(ndarray);
+    self->mats[i] = ndarray_to_mat_header(ndarray);
+    if(self->mats[i].empty() && ndarray->len > 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Bound arrays must have 3 dimensions or less"));
+    }
+}
+
+static void bind_point(mp_obj_t obj, int* point)
+{
+    Point pt = obj == mp_const_none ? Point(-1, -1) : mp_obj_to_point(obj);
+    point[0] = pt.x;
+    point[1] = pt.y;
+}
+
+static void bind_size(mp_obj_t obj, int* size)
+{
+    Size sz = mp_obj_to_size(obj);
+    size[0] = sz.width;
+    size[1] = sz.height;
+}
+
+// Rows of context a filter needs on each side of a row, see filter_halo().
+// Isolated borders treat the edges of each strip as the edges of the image, so
+// those can't run on strips
+static int strip_halo(int halo, int borderType)
+{
+    return (borderType & BORDER_ISOLATED) ? -1 : halo;
+}
+
+static const mp_arg_t threshold_args[] = {
+    { MP_QSTR_thresh, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    { MP_QSTR_maxval, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    { MP_QSTR_type, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = THRESH_BINARY } },
+    { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+};
+
+static void threshold_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    self->p.threshold.thresh = mp_obj_get_float(args[0].u_obj);
+    self->p.threshold.maxval = mp_obj_get_float(args[1].u_obj);
+    self->p.threshold.type = args[2].u_int;
+    bind_dst(self, args[3].u_obj);
+}
+
+static double threshold_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    return op_threshold(src, dst, self->p.threshold.thresh, self->p.threshold.maxval, self->p.threshold.type);
+}
+
+// Otsu's and the triangle methods compute the threshold from the whole image
+static int threshold_halo(cv2_bound_obj_t* self)
+{
+    return (self->p.threshold.type & (THRESH_OTSU | THRESH_TRIANGLE)) ? -1 : 0;
+}
+
+static const mp_arg_t cvtColor_args[] = {
+    { MP_QSTR_code, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
+    { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+};
+
+static void cvtColor_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    self->p.cvtColor.code = args[0].u_int;
+    bind_dst(self, args[1].u_obj);
+}
+
+static double cvtColor_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    op_cvtColor(src, dst, self->p.cvtColor.code);
+    return 0;
+}
+
+// Conversions that change the number of rows are caught by the pipeline, since
+// that depends on src
+static int cvtColor_halo(cv2_bound_obj_t* self)
+{
+    return is_bayer_code(self->p.cvtColor.code) ? -1 : 0;
+}
+
+static const mp_arg_t blur_args[] = {
+    { MP_QSTR_ksize, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_anchor, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_borderType, MP_ARG_INT, { .u_int = BORDER_DEFAULT } },
+};
+
+static void blur_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    bind_size(args[0].u_obj, self->p.blur.ksize);
+    bind_dst(self, args[1].u_obj);
+    bind_point(args[2].u_obj, self->p.blur.anchor);
+    self->p.blur.borderType = args[3].u_int;
+}
+
+static double blur_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    op_blur(src, dst, Size(self->p.blur.ksize[0], self->p.blur.ksize[1]),
+        Point(self->p.blur.anchor[0], self->p.blur.anchor[1]), self->p.blur.borderType);
+    return 0;
+}
+
+static int blur_halo(cv2_bound_obj_t* self)
+{
+    return strip_halo(filter_halo(self->p.blur.ksize[1], self->p.blur.anchor[1]), self->p.blur.borderType);
+}
+
+static const mp_arg_t GaussianBlur_args[] = {
+    { MP_QSTR_ksize, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    { MP_QSTR_sigmaX, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_sigmaY, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_borderType, MP_ARG_INT, { .u_int = BORDER_DEFAULT } },
+    { MP_QSTR_hint, MP_ARG_INT, { .u_int = ALGO_HINT_DEFAULT } },
+};
+
+static void GaussianBlur_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    bind_size(args[0].u_obj, self->p.GaussianBlur.ksize);
+    self->p.GaussianBlur.sigmaX = mp_obj_get_float(args[1].u_obj);
+    bind_dst(self, args[2].u_obj);
+    self->p.GaussianBlur.sigmaY = args[3].u_obj == mp_const_none ? self->p.GaussianBlur.sigmaX : mp_obj_get_float(args[3].u_obj);
+    self->p.GaussianBlur.borderType = args[4].u_int;
+    self->p.GaussianBlur.hint = args[5].u_int;
+}
+
+static double GaussianBlur_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    op_GaussianBlur(src, dst, Size(self->p.GaussianBlur.ksize[0], self->p.GaussianBlur.ksize[1]),
+        self->p.GaussianBlur.sigmaX, self->p.GaussianBlur.sigmaY, self->p.GaussianBlur.borderType,
+        (AlgorithmHint) self->p.GaussianBlur.hint);
+    return 0;
+}
+
+static int GaussianBlur_halo(cv2_bound_obj_t* self)
+{
+    double sigma = self->p.GaussianBlur.sigmaY > 0 ? self->p.GaussianBlur.sigmaY : self->p.GaussianBlur.sigmaX;
+    return strip_halo(gaussian_halo(self->p.GaussianBlur.ksize[1], sigma), self->p.GaussianBlur.borderType);
+}
+
+static const mp_arg_t medianBlur_args[] = {
+    { MP_QSTR_ksize, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
+    { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+};
+
+static void medianBlur_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    self->p.medianBlur.ksize = args[0].u_int;
+    bind_dst(self, args[1].u_obj);
+}
+
+static double medianBlur_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    medianBlur(src, dst, self->p.medianBlur.ksize);
+    return 0;
+}
+
+// erode() and dilate() take the same arguments
+static const mp_arg_t morph_args[] = {
+    { MP_QSTR_kernel, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_anchor, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_iterations, MP_ARG_INT, { .u_int = 1 } },
+    { MP_QSTR_borderType, MP_ARG_INT, { .u_int = BORDER_CONSTANT } },
+    { MP_QSTR_borderValue, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+};
+
+static void morph_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    bind_mat(self, 0, args[0].u_obj);
+    bind_dst(self, args[1].u_obj);
+    bind_point(args[2].u_obj, self->p.morph.anchor);
+    self->p.morph.iterations = args[3].u_int;
+    self->p.morph.borderType = args[4].u_int;
+    Scalar borderValue = args[5].u_obj == mp_const_none ? morphologyDefaultBorderValue() : mp_obj_to_scalar(args[5].u_obj);
+    for(int i = 0; i < 4; i++)
+        self->p.morph.borderValue[i] = borderValue[i];
+}
+
+// Each iteration needs the result of the previous one from the neighboring
+// strips, so only a single iteration can run on strips. An empty kernel is a
+// 3x3 rectangle
+static int morph_halo(cv2_bound_obj_t* self)
+{
+    if(self->p.morph.iterations != 1)
+        return -1;
+    int rows = self->mats[0].empty() ? 3 : self->mats[0].rows;
+    return strip_halo(filter_halo(rows, self->p.morph.anchor[1]), self->p.morph.borderType);
+}
+
+static double erode_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    const double* v = self->p.morph.borderValue;
+    op_erode(src, dst, self->mats[0], Point(self->p.morph.anchor[0], self->p.morph.anchor[1]),
+        self->p.morph.iterations, self->p.morph.borderType, Scalar(v[0], v[1], v[2], v[3]));
+    return 0;
+}
+
+static double dilate_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    const double* v = self->p.morph.borderValue;
+    op_dilate(src, dst, self->mats[0], Point(self->p.morph.anchor[0], self->p.morph.anchor[1]),
+        self->p.morph.iterations, self->p.morph.borderType, Scalar(v[0], v[1], v[2], v[3]));
+    return 0;
+}
+
+static const mp_arg_t morphologyEx_args[] = {
+    { MP_QSTR_op, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
+    { MP_QSTR_kernel, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_anchor, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_iterations, MP_ARG_INT, { .u_int = 1 } },
+    { MP_QSTR_borderType, MP_ARG_INT, { .u_int = BORDER_CONSTANT } },
+    { MP_QSTR_borderValue, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+};
+
+static void morphologyEx_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    self->p.morph.op = args[0].u_int;
+    morph_bind(self, args + 1);
+}
+
+static double morphologyEx_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    const double* v = self->p.morph.borderValue;
+    morphologyEx(src, dst, self->p.morph.op, self->mats[0], Point(self->p.morph.anchor[0], self->p.morph.anchor[1]),
+        self->p.morph.iterations, self->p.morph.borderType, Scalar(v[0], v[1], v[2], v[3]));
+    return 0;
+}
+
+static const mp_arg_t inRange_args[] = {
+    { MP_QSTR_lower, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    { MP_QSTR_upper, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+};
+
+static void inRange_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    bind_mat(self, 0, args[0].u_obj);
+    bind_mat(self, 1, args[1].u_obj);
+    bind_dst(self, args[2].u_obj);
+}
+
+static double inRange_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst)
+{
+    op_inRange(src, self->mats[0], self->mats[1], dst);
+    return 0;
+}
+
+// Bounds that are arrays the same size as src would need to be split into
+// strips too, so only scalar bounds can run on strips
+static int inRange_halo(cv2_bound_obj_t* self)
+{
+    return (self->mats[0].total() <= 4 && self->mats[1].total() <= 4) ? 0 : -1;
+}
+
+static const mp_arg_t findContours_args[] = {
+    { MP_QSTR_mode, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
+    { MP_QSTR_method, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
+    { MP_QSTR_offset, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    { MP_QSTR_packed, MP_ARG_BOOL, { .u_bool = false } },
+};
+
+static void findContours_bind(cv2_bound_obj_t* self, const mp_arg_val_t* args)
+{
+    self->p.findContours.mode = args[0].u_int;
+    self->p.findContours.method = args[1].u_int;
+    Point offset = args[2].u_obj == mp_const_none ? Point() : mp_obj_to_point(args[2].u_obj);
+    self->p.findContours.offset[0] = offset.x;
+    self->p.findContours.offset[1] = offset.y;
+    self->p.findContours.packed = args[3].u_bool;
+}
+
+static mp_obj_t findContours_finish(cv2_bound_obj_t* self, const Mat& src)
+{
+    std::vector<std::vector<Point>> contours;
+    std::vector<Vec4i> hierarchy;
+    try {
+        findContours(src, contours, hierarchy, self->p.findContours.mode, self->p.findContours.method,
+            Point(self->p.findContours.offset[0], self->p.findContours.offset[1]));
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+    return contours_to_mp_obj(contours, hierarchy, self->p.findContours.packed);
+}
+
+// Operations that can be bound, identified by their wrapper
+static const BoundOp bound_ops[] = {
+    { cv2_imgproc_threshold, threshold_args, MP_ARRAY_SIZE(threshold_args), threshold_bind, threshold_run, nullptr, threshold_halo, true },
+    { cv2_imgproc_cvtColor, cvtColor_args, MP_ARRAY_SIZE(cvtColor_args), cvtColor_bind, cvtColor_run, nullptr, cvtColor_halo, false },
+    { cv2_imgproc_blur, blur_args, MP_ARRAY_SIZE(blur_args), blur_bind, blur_run, nullptr, blur_halo, false },
+    { cv2_imgproc_GaussianBlur, GaussianBlur_args, MP_ARRAY_SIZE(GaussianBlur_args), GaussianBlur_bind, GaussianBlur_run, nullptr, GaussianBlur_halo, false },
+    { cv2_imgproc_medianBlur, medianBlur_args, MP_ARRAY_SIZE(medianBlur_args), medianBlur_bind, medianBlur_run, nullptr, nullptr, false },
+    { cv2_imgproc_erode, morph_args, MP_ARRAY_SIZE(morph_args), morph_bind, erode_run, nullptr, morph_halo, false },
+    { cv2_imgproc_dilate, morph_args, MP_ARRAY_SIZE(morph_args), morph_bind, dilate_run, nullptr, morph_halo, false },
+    { cv2_imgproc_morphologyEx, morphologyEx_args, MP_ARRAY_SIZE(morphologyEx_args), morphologyEx_bind, morphologyEx_run, nullptr, nullptr, false },
+    { cv2_core_inRange, inRange_args, MP_ARRAY_SIZE(inRange_args), inRange_bind, inRange_run, nullptr, inRange_halo, false },
+    { cv2_imgproc_findContours, findContours_args, MP_ARRAY_SIZE(findContours_args), findContours_bind, nullptr, findContours_finish, nullptr, false },
+};
+
+// Returns the BoundOp for a function from the cv2 module, or nullptr. The
+// function objects are defined static in each header, so they're compared by
+// the wrapper they call instead
+static const BoundOp* bound_op_find(mp_obj_t fun)
+{
+    if(!mp_obj_is_type(fun, &mp_type_fun_builtin_var))
+        return nullptr;
+    const mp_obj_fun_builtin_var_t *builtin = (const mp_obj_fun_builtin_var_t*) MP_OBJ_TO_PTR(fun);
+    // The lowest bit of the signature is set for functions that take keyword
+    // arguments, see MP_OBJ_FUN_MAKE_SIG()
+    if(!(builtin->sig & 1))
+        return nullptr;
+    for(size_t i = 0; i < MP_ARRAY_SIZE(bound_ops); i++)
+    {
+        if(bound_ops[i].fun == builtin->fun.kw)
+            return &bound_ops[i];
+    }
+    return nullptr;
+}
+
+mp_obj_t bound_new(mp_obj_t fun, mp_map_t* kw_args)
+{
+    const BoundOp* op = bound_op_find(fun);
+    if(op == nullptr)
+    {
+        mp_raise_TypeError(MP_ERROR_TEXT("Function can't be bound"));
+    }
+
+    // Parse the arguments
+    mp_arg_val_t args[BIND_MAX_ARGS];
+    mp_arg_parse_all(0, NULL, kw_args, op->n_args, op->args, args);
+
+    // Create the object, and convert the arguments
+    cv2_bound_obj_t* self = new (m_new_obj(cv2_bound_obj_t)) cv2_bound_obj_t();
+    self->base.type = &cv2_bound_type;
+    self->op = op;
+    self->dst_obj = mp_const_none;
+    self->objs[0] = self->objs[1] = mp_const_none;
+    op->bind(self, args);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+cv2_bound_obj_t* bound_from_mp_obj(mp_obj_t obj)
+{
+    if(!mp_obj_is_type(obj, &cv2_bound_type))
+        return nullptr;
+    return (cv2_bound_obj_t*) MP_OBJ_TO_PTR(obj);
+}
+
+Mat bound_src(mp_obj_t obj)
+{
+    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
+    Mat src = ndarray_to_mat_header(ndarray);
+    if(src.empty())
+        src = ndarray_to_mat(ndarray);
+    return src;
+}
+
+double bound_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst, mp_obj_t& dst_obj)
+{
+    Mat out = dst.empty() ? mp_obj_to_mat(dst_obj) : dst;
+    out.allocator = &GetNumpyAllocator();
+
+    double retval = 0;
+    try {
+        retval = self->op->run(self, src, out);
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    if(dst.empty() || out.data != dst.data)
+    {
+        ndarray_obj_t *ndarray = mat_to_ndarray(out);
+        dst_obj = MP_OBJ_FROM_PTR(ndarray);
+        dst = ndarray_to_mat_header(ndarray);
+    }
+    return retval;
+}
+
+mp_obj_t bound_result(cv2_bound_obj_t* self, mp_obj_t dst_obj, double retval)
+{
+    if(!self->op->has_retval)
+        return dst_obj;
+    mp_obj_t result_tuple[2];
+    result_tuple[0] = mp_obj_new_float(retval);
+    result_tuple[1] = dst_obj;
+    return mp_obj_new_tuple(2, result_tuple);
+}
+
+mp_obj_t cv2_bind(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    // Only the function is positional, since src is left unbound
+    if(n_args != 1)
+    {
+        mp_raise_TypeError(MP_ERROR_TEXT("bind() takes the function, then keyword arguments"));
+    }
+    return bound_new(pos_args[0], kw_args);
+}
+
+extern "C" mp_obj_t cv2_bind_bound_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    CV2_PROFILE_FUNCTION();
+
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    cv2_bound_obj_t* self = (cv2_bound_obj_t*) MP_OBJ_TO_PTR(self_in);
+
+    // Only src needs converting
+    Mat src = bound_src(args[0]);
+
+    // Operations without an image output return their whole result
+    if(self->op->finish != nullptr)
+    {
+        CV2_PROFILE_PHASE(COMPUTE);
+        return self->op->finish(self, src);
+    }
+
+    // Use the bound dst. If OpenCV has to reallocate it (eg. src has a
+    // different size), the new dst is returned instead, like the wrappers do,
+    // but the bound one is kept for the next call
+    CV2_PROFILE_PHASE(COMPUTE);
+    Mat dst = self->dst;
+    mp_obj_t dst_obj = self->dst_obj;
+    double retval = bound_run(self, src, dst, dst_obj);
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return bound_result(self, dst_obj, retval);
+}
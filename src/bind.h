@@ -0,0 +1,25 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * bind.h
+ * 
+ * MicroPython wrappers for bound operations, see bind.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Function declarations
+extern mp_obj_t cv2_bind(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+
+// Python references to the functions
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bind_obj, 1, cv2_bind);
+
+// Global definitions for functions and constants
+#define OPENCV_BIND_GLOBALS \
+    /* Functions */ \
+    { MP_ROM_QSTR(MP_QSTR_bind), MP_ROM_PTR(&cv2_bind_obj) }
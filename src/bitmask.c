@@ -0,0 +1,57 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * bitmask.c
+ * 
+ * Type of cv2.BitMask. The type is defined in C, since MicroPython's type
+ * macros don't compile as C++. Everything else is in bitmask.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "bitmask.h"
+
+// Defined in bitmask.cpp
+extern mp_obj_t cv2_bitmask_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args);
+extern void cv2_bitmask_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest);
+extern mp_obj_t cv2_bitmask_BitMask_bitwise_and(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_bitmask_BitMask_bitwise_not(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_bitmask_BitMask_bitwise_or(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_bitmask_BitMask_countNonZero(mp_obj_t self_in);
+extern mp_obj_t cv2_bitmask_BitMask_dilate(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_bitmask_BitMask_erode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_bitmask_BitMask_morphologyEx(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_bitmask_BitMask_toArray(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_BitMask_bitwise_and_obj, 2, cv2_bitmask_BitMask_bitwise_and);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_BitMask_bitwise_not_obj, 1, cv2_bitmask_BitMask_bitwise_not);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_BitMask_bitwise_or_obj, 2, cv2_bitmask_BitMask_bitwise_or);
+static MP_DEFINE_CONST_FUN_OBJ_1(cv2_bitmask_BitMask_countNonZero_obj, cv2_bitmask_BitMask_countNonZero);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_BitMask_dilate_obj, 2, cv2_bitmask_BitMask_dilate);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_BitMask_erode_obj, 2, cv2_bitmask_BitMask_erode);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_BitMask_morphologyEx_obj, 3, cv2_bitmask_BitMask_morphologyEx);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_BitMask_toArray_obj, 1, cv2_bitmask_BitMask_toArray);
+
+static const mp_rom_map_elem_t cv2_bitmask_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_bitwise_and), MP_ROM_PTR(&cv2_bitmask_BitMask_bitwise_and_obj) },
+    { MP_ROM_QSTR(MP_QSTR_bitwise_not), MP_ROM_PTR(&cv2_bitmask_BitMask_bitwise_not_obj) },
+    { MP_ROM_QSTR(MP_QSTR_bitwise_or), MP_ROM_PTR(&cv2_bitmask_BitMask_bitwise_or_obj) },
+    { MP_ROM_QSTR(MP_QSTR_countNonZero), MP_ROM_PTR(&cv2_bitmask_BitMask_countNonZero_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dilate), MP_ROM_PTR(&cv2_bitmask_BitMask_dilate_obj) },
+    { MP_ROM_QSTR(MP_QSTR_erode), MP_ROM_PTR(&cv2_bitmask_BitMask_erode_obj) },
+    { MP_ROM_QSTR(MP_QSTR_morphologyEx), MP_ROM_PTR(&cv2_bitmask_BitMask_morphologyEx_obj) },
+    { MP_ROM_QSTR(MP_QSTR_toArray), MP_ROM_PTR(&cv2_bitmask_BitMask_toArray_obj) },
+};
+static MP_DEFINE_CONST_DICT(cv2_bitmask_locals_dict, cv2_bitmask_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    cv2_bitmask_type,
+    MP_QSTR_BitMask,
+    MP_TYPE_FLAG_NONE,
+    make_new, cv2_bitmask_make_new,
+    attr, cv2_bitmask_attr,
+    locals_dict, &cv2_bitmask_locals_dict
+    );
@@ -0,0 +1,538 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * bitmask.cpp
+ * 
+ * Bit-packed binary masks. A cv2.BitMask stores one bit per pixel, 32 pixels
+ * to a word, so a mask takes an eighth of the memory of a uint8 mask, and
+ * logic and morphology process 32 pixels per operation.
+ * 
+ * cv.thresholdBits() and cv.inRangeBits() compute the mask one row at a time
+ * into a line buffer and pack each row straight away, so the uint8 mask is
+ * never allocated.
+ * 
+ * Erosion and dilation only support rectangular kernels, which are separable:
+ * each row is combined with shifted copies of itself for the width of the
+ * kernel, then each output row combines the rows of that result for the
+ * height of the kernel. Like OpenCV's default border, pixels outside the mask
+ * count as foreground for erosion and as background for dilation.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+#include "convert.h"
+#include "numpy.h"
+#include "ops.h"
+#include "parallel.h"
+#include "profile_scope.h"
+
+// C headers
+extern "C" {
+#include "bitmask.h"
+} // extern "C"
+
+using namespace cv;
+
+// A bit-packed binary mask. Row y is the stride words from words + y * stride,
+// with pixel x in bit x % 32 of word x / 32. The bits past cols in the last
+// word of each row are always clear, so whole words can be counted
+struct cv2_bitmask_obj_t
+{
+    mp_obj_base_t base;
+    int rows;
+    int cols;
+    int stride;
+    uint32_t* words;
+};
+
+// Bits of the last word of a row that are inside the mask
+static inline uint32_t last_word_bits(int cols)
+{
+    int r = cols % 32;
+    return r ? (1u << r) - 1 : ~0u;
+}
+
+// Packs a row of a mask that is nonzero for foreground pixels
+static void pack_row(const uchar* src, int cols, uint32_t* dst)
+{
+    for(int x0 = 0; x0 < cols; x0 += 32)
+    {
+        int n = std::min(32, cols - x0);
+        uint32_t word = 0;
+        for(int b = 0; b < n; b++)
+            word |= (uint32_t) (src[x0 + b] != 0) << b;
+        *dst++ = word;
+    }
+}
+
+// Unpacks a row into a mask that is 255 for foreground pixels
+static void unpack_row(const uint32_t* src, int cols, uchar* dst)
+{
+    for(int x0 = 0; x0 < cols; x0 += 32)
+    {
+        int n = std::min(32, cols - x0);
+        uint32_t word = *src++;
+        for(int b = 0; b < n; b++)
+            dst[x0 + b] = (uchar) -(int) ((word >> b) & 1);
+    }
+}
+
+// ANDs (for erosion) or ORs (for dilation) a row of n words into dst, shifted
+// so bit x of dst is combined with bit x + d of src. Words outside the row
+// read as fill
+static void shift_combine(const uint32_t* src, uint32_t* dst, int n, int d, uint32_t fill, bool erode)
+{
+    int q = d >= 0 ? d / 32 : -((31 - d) / 32);
+    int r = d - 32 * q;
+    for(int i = 0; i < n; i++)
+    {
+        int j = i + q;
+        uint32_t word = (j >= 0 && j < n ? src[j] : fill) >> r;
+        if(r != 0)
+            word |= (j + 1 >= 0 && j + 1 < n ? src[j + 1] : fill) << (32 - r);
+        dst[i] = erode ? dst[i] & word : dst[i] | word;
+    }
+}
+
+// Erodes or dilates src into dst once, with a kw x kh rectangle anchored at
+// (ax, ay). tmp must have room for a mask of the same size. dst may be src
+static void morph_rect(const uint32_t* src, uint32_t* dst, uint32_t* tmp, int rows, int cols, int stride,
+                       int kw, int kh, int ax, int ay, bool erode)
+{
+    // Erosion ANDs and dilation ORs, so the border value is also the identity
+    uint32_t fill = erode ? ~0u : 0u;
+    uint32_t last = last_word_bits(cols);
+
+    // Combine each row with itself, shifted across the width of the kernel.
+    // The padding bits of the last word are border pixels too
+    parallel_rows(rows, [&](const Range& range) {
+        std::vector<uint32_t> line(stride);
+        for(int y = range.start; y < range.end; y++)
+        {
+            std::copy(src + y * stride, src + (y + 1) * stride, line.begin());
+            line[stride - 1] |= fill & ~last;
+            uint32_t* t = tmp + y * stride;
+            std::fill(t, t + stride, fill);
+            for(int dx = -ax; dx < kw - ax; dx++)
+                shift_combine(line.data(), t, stride, dx, fill, erode);
+        }
+    });
+
+    // Combine the rows across the height of the kernel. Rows outside the mask
+    // are the identity, so they're skipped
+    parallel_rows(rows, [&](const Range& range) {
+        for(int y = range.start; y < range.end; y++)
+        {
+            uint32_t* d = dst + y * stride;
+            std::fill(d, d + stride, fill);
+            for(int sy = std::max(y - ay, 0); sy < std::min(y + kh - ay, rows); sy++)
+            {
+                const uint32_t* t = tmp + sy * stride;
+                if(erode)
+                    for(int i = 0; i < stride; i++)
+                        d[i] &= t[i];
+                else
+                    for(int i = 0; i < stride; i++)
+                        d[i] |= t[i];
+            }
+            d[stride - 1] &= last;
+        }
+    });
+}
+
+// Creates an uninitialized BitMask
+static cv2_bitmask_obj_t* bitmask_new(int rows, int cols)
+{
+    cv2_bitmask_obj_t *self = m_new_obj(cv2_bitmask_obj_t);
+    self->base.type = &cv2_bitmask_type;
+    self->rows = rows;
+    self->cols = cols;
+    self->stride = std::max((cols + 31) / 32, 1);
+    self->words = m_new(uint32_t, (size_t) std::max(rows, 1) * self->stride);
+    return self;
+}
+
+static cv2_bitmask_obj_t* bitmask_from_mp_obj(mp_obj_t obj)
+{
+    if(!mp_obj_is_type(obj, &cv2_bitmask_type))
+        mp_raise_TypeError(MP_ERROR_TEXT("Expected a BitMask"));
+    return (cv2_bitmask_obj_t*) MP_OBJ_TO_PTR(obj);
+}
+
+// Returns the BitMask to write a result of the given size into. Like dst
+// arrays, dst is used if it's a BitMask of that size, and a new one is
+// allocated otherwise
+static cv2_bitmask_obj_t* bitmask_dst(mp_obj_t dst_obj, int rows, int cols)
+{
+    if(dst_obj != mp_const_none)
+    {
+        cv2_bitmask_obj_t* dst = bitmask_from_mp_obj(dst_obj);
+        if(dst->rows == rows && dst->cols == cols)
+            return dst;
+    }
+    return bitmask_new(rows, cols);
+}
+
+// Packs a mask into dst. row_fn returns row y of the mask, which is nonzero for
+// foreground pixels, and can compute it into line, a CV_8UC1 row that belongs
+// to the calling core
+static void bitmask_pack(cv2_bitmask_obj_t* dst, const std::function<const uchar*(int, Mat&)>& row_fn)
+{
+    parallel_rows(dst->rows, [&](const Range& range) {
+        Mat line(1, dst->cols, CV_8UC1);
+        for(int y = range.start; y < range.end; y++)
+            pack_row(row_fn(y, line), dst->cols, dst->words + y * dst->stride);
+    });
+}
+
+// Reads a kernel for erosion and dilation, which must be a rectangle of
+// nonzero values. An empty kernel is 3x3, like in OpenCV
+static void bitmask_kernel(const Mat& kernel, Point anchor, int& kw, int& kh, int& ax, int& ay)
+{
+    kw = kh = 3;
+    if(!kernel.empty())
+    {
+        if(kernel.channels() != 1 || countNonZero(kernel) != (int) kernel.total())
+            CV_Error(Error::StsBadArg, "BitMask morphology only supports rectangular kernels");
+        kw = kernel.cols;
+        kh = kernel.rows;
+    }
+    ax = anchor.x < 0 ? kw / 2 : anchor.x;
+    ay = anchor.y < 0 ? kh / 2 : anchor.y;
+    CV_Assert(ax < kw && ay < kh);
+}
+
+// Erodes and/or dilates src into dst, with the steps of op (a MORPH_* constant)
+static void bitmask_morph(cv2_bitmask_obj_t* src, cv2_bitmask_obj_t* dst, int op, const Mat& kernel, Point anchor, int iterations)
+{
+    bool steps[2];
+    int n_steps;
+    switch(op)
+    {
+        case MORPH_ERODE: steps[0] = true; n_steps = 1; break;
+        case MORPH_DILATE: steps[0] = false; n_steps = 1; break;
+        case MORPH_OPEN: steps[0] = true; steps[1] = false; n_steps = 2; break;
+        case MORPH_CLOSE: steps[0] = false; steps[1] = true; n_steps = 2; break;
+        default: CV_Error(Error::StsBadArg, "BitMask only supports MORPH_ERODE, MORPH_DILATE, MORPH_OPEN and MORPH_CLOSE");
+    }
+
+    int kw, kh, ax, ay;
+    bitmask_kernel(kernel, anchor, kw, kh, ax, ay);
+    std::vector<uint32_t> tmp((size_t) src->rows * src->stride);
+    const uint32_t* in = src->words;
+    for(int s = 0; s < n_steps; s++)
+    {
+        for(int i = 0; i < iterations; i++)
+        {
+            morph_rect(in, dst->words, tmp.data(), src->rows, src->cols, src->stride, kw, kh, ax, ay, steps[s]);
+            in = dst->words;
+        }
+    }
+    if(in != dst->words)
+        std::copy(in, in + (size_t) src->rows * src->stride, dst->words);
+}
+
+extern "C" mp_obj_t cv2_bitmask_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_mask };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_mask, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t parsed[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, args, MP_ARRAY_SIZE(allowed_args), allowed_args, parsed);
+
+    // Convert arguments to required types
+    Mat mask = mp_obj_to_mat(parsed[ARG_mask].u_obj);
+    if(mask.type() != CV_8UC1)
+        mp_raise_TypeError(MP_ERROR_TEXT("BitMask needs a 2D uint8 mask"));
+    cv2_bitmask_obj_t *self = bitmask_new(mask.rows, mask.cols);
+
+    // Pack the rows of the mask as they are
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        bitmask_pack(self, [&](int y, Mat&) {
+            return mask.ptr<uchar>(y);
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+extern "C" void cv2_bitmask_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    cv2_bitmask_obj_t *self = (cv2_bitmask_obj_t*) MP_OBJ_TO_PTR(self_in);
+
+    // shape is read-only, like an ndarray's. Everything else is looked up in
+    // the locals dict
+    if(dest[0] == MP_OBJ_NULL && attr == MP_QSTR_shape) {
+        mp_obj_t shape[2];
+        shape[0] = mp_obj_new_int(self->rows);
+        shape[1] = mp_obj_new_int(self->cols);
+        dest[0] = mp_obj_new_tuple(2, shape);
+    } else {
+        dest[1] = MP_OBJ_SENTINEL;
+    }
+}
+
+// Shared by bitwise_and() and bitwise_or()
+static mp_obj_t bitmask_bitwise(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args, bool is_and) {
+    cv2_bitmask_obj_t *self = bitmask_from_mp_obj(pos_args[0]);
+
+    // Define the arguments
+    enum { ARG_other, ARG_dst };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_other, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    cv2_bitmask_obj_t *other = bitmask_from_mp_obj(args[ARG_other].u_obj);
+    if(other->rows != self->rows || other->cols != self->cols)
+        mp_raise_ValueError(MP_ERROR_TEXT("BitMasks must be the same size"));
+    cv2_bitmask_obj_t *dst = bitmask_dst(args[ARG_dst].u_obj, self->rows, self->cols);
+
+    // The padding bits are clear in both, so they stay clear
+    size_t n = (size_t) self->rows * self->stride;
+    if(is_and)
+        for(size_t i = 0; i < n; i++)
+            dst->words[i] = self->words[i] & other->words[i];
+    else
+        for(size_t i = 0; i < n; i++)
+            dst->words[i] = self->words[i] | other->words[i];
+    return MP_OBJ_FROM_PTR(dst);
+}
+
+extern "C" mp_obj_t cv2_bitmask_BitMask_bitwise_and(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    return bitmask_bitwise(n_args, pos_args, kw_args, true);
+}
+
+extern "C" mp_obj_t cv2_bitmask_BitMask_bitwise_not(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    cv2_bitmask_obj_t *self = bitmask_from_mp_obj(pos_args[0]);
+
+    // Define the arguments
+    enum { ARG_dst };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    cv2_bitmask_obj_t *dst = bitmask_dst(args[ARG_dst].u_obj, self->rows, self->cols);
+
+    // Inverting sets the padding bits, so they get cleared again
+    CV2_PROFILE_PHASE(COMPUTE);
+    uint32_t last = last_word_bits(self->cols);
+    for(int y = 0; y < self->rows; y++) {
+        const uint32_t* s = self->words + y * self->stride;
+        uint32_t* d = dst->words + y * self->stride;
+        for(int i = 0; i < self->stride; i++)
+            d[i] = ~s[i];
+        d[self->stride - 1] &= last;
+    }
+    return MP_OBJ_FROM_PTR(dst);
+}
+
+extern "C" mp_obj_t cv2_bitmask_BitMask_bitwise_or(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    return bitmask_bitwise(n_args, pos_args, kw_args, false);
+}
+
+extern "C" mp_obj_t cv2_bitmask_BitMask_countNonZero(mp_obj_t self_in) {
+    cv2_bitmask_obj_t *self = bitmask_from_mp_obj(self_in);
+
+    mp_uint_t count = 0;
+    size_t n = (size_t) self->rows * self->stride;
+    for(size_t i = 0; i < n; i++)
+        count += __builtin_popcount(self->words[i]);
+    return mp_obj_new_int_from_uint(count);
+}
+
+// Shared by erode(), dilate() and morphologyEx(). op is -1 if it's an argument
+static mp_obj_t bitmask_morphology(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args, int op) {
+    cv2_bitmask_obj_t *self = bitmask_from_mp_obj(pos_args[0]);
+
+    // Define the arguments
+    enum { ARG_op, ARG_kernel, ARG_dst, ARG_anchor, ARG_iterations };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_op, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
+        { MP_QSTR_kernel, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+        { MP_QSTR_anchor, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+        { MP_QSTR_iterations, MP_ARG_INT, { .u_int = 1 } },
+    };
+
+    // Parse the arguments. erode() and dilate() don't take op
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    if(op < 0) {
+        mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+        op = args[ARG_op].u_int;
+    } else {
+        mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args) - 1, allowed_args + 1, args + 1);
+    }
+
+    // Convert arguments to required types
+    Mat kernel = mp_obj_to_mat(args[ARG_kernel].u_obj);
+    Point anchor = args[ARG_anchor].u_obj == mp_const_none ? Point(-1, -1) : mp_obj_to_point(args[ARG_anchor].u_obj);
+    int iterations = args[ARG_iterations].u_int;
+    cv2_bitmask_obj_t *dst = bitmask_dst(args[ARG_dst].u_obj, self->rows, self->cols);
+
+    // Call the morphology function
+    try {
+        bitmask_morph(self, dst, op, kernel, anchor, iterations);
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    return MP_OBJ_FROM_PTR(dst);
+}
+
+extern "C" mp_obj_t cv2_bitmask_BitMask_dilate(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    return bitmask_morphology(n_args, pos_args, kw_args, MORPH_DILATE);
+}
+
+extern "C" mp_obj_t cv2_bitmask_BitMask_erode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    return bitmask_morphology(n_args, pos_args, kw_args, MORPH_ERODE);
+}
+
+extern "C" mp_obj_t cv2_bitmask_BitMask_morphologyEx(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    return bitmask_morphology(n_args, pos_args, kw_args, -1);
+}
+
+extern "C" mp_obj_t cv2_bitmask_BitMask_toArray(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    cv2_bitmask_obj_t *self = bitmask_from_mp_obj(pos_args[0]);
+
+    // Define the arguments
+    enum { ARG_dst };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat dst = mp_obj_to_mat(args[ARG_dst].u_obj);
+
+    // Foreground pixels are set to 255, like the masks from cv.inRange()
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        dst.create(self->rows, self->cols, CV_8UC1);
+        parallel_rows(self->rows, [&](const Range& range) {
+            for(int y = range.start; y < range.end; y++)
+                unpack_row(self->words + y * self->stride, self->cols, dst.ptr<uchar>(y));
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return mat_to_mp_obj(dst);
+}
+
+mp_obj_t cv2_bitmask_inRangeBits(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_src, ARG_lower, ARG_upper, ARG_dst };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_lower, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_upper, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat src = mp_obj_to_mat(args[ARG_src].u_obj);
+    Mat lower = mp_obj_to_mat(args[ARG_lower].u_obj);
+    Mat upper = mp_obj_to_mat(args[ARG_upper].u_obj);
+    cv2_bitmask_obj_t *dst = bitmask_dst(args[ARG_dst].u_obj, src.rows, src.cols);
+
+    // Each row of the mask is computed by op_inRange_row() into the line
+    // buffer, with the bounds converted once up front
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        InRangeBounds bounds = op_inRange_bounds(src.size(), src.type(), lower, upper);
+        bitmask_pack(dst, [&](int y, Mat& line) {
+            op_inRange_row(bounds, src.row(y), y, line);
+            return line.ptr<uchar>();
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    return MP_OBJ_FROM_PTR(dst);
+}
+
+mp_obj_t cv2_bitmask_thresholdBits(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_src, ARG_thresh, ARG_type, ARG_dst };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_thresh, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_type, MP_ARG_INT, { .u_int = THRESH_BINARY } },
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat src = mp_obj_to_mat(args[ARG_src].u_obj);
+    mp_float_t thresh = mp_obj_get_float(args[ARG_thresh].u_obj);
+    int type = args[ARG_type].u_int;
+    cv2_bitmask_obj_t *dst = bitmask_dst(args[ARG_dst].u_obj, src.rows, src.cols);
+
+    // Each row of the mask is computed by op_threshold() into the line buffer.
+    // Otsu's and the triangle methods need the whole image to pick the
+    // threshold, so they aren't supported
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        CV_Assert(src.type() == CV_8UC1);
+        CV_Assert(!(type & (THRESH_OTSU | THRESH_TRIANGLE)));
+        bitmask_pack(dst, [&](int y, Mat& line) {
+            op_threshold(src.row(y), line, thresh, 255, type);
+            return line.ptr<uchar>();
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    mp_obj_t result[2];
+    result[0] = mp_obj_new_float(thresh);
+    result[1] = MP_OBJ_FROM_PTR(dst);
+    return mp_obj_new_tuple(2, result);
+}
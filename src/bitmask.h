@@ -0,0 +1,33 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * bitmask.h
+ * 
+ * MicroPython wrappers for bit-packed binary masks, see bitmask.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Type definitions, see bitmask.c
+extern const mp_obj_type_t cv2_bitmask_type;
+
+// Function declarations
+extern mp_obj_t cv2_bitmask_inRangeBits(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_bitmask_thresholdBits(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+
+// Python references to the functions
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_inRangeBits_obj, 3, cv2_bitmask_inRangeBits);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_bitmask_thresholdBits_obj, 2, cv2_bitmask_thresholdBits);
+
+// Global definitions for functions and constants
+#define OPENCV_BITMASK_GLOBALS \
+    /* Types */ \
+    { MP_ROM_QSTR(MP_QSTR_BitMask), MP_ROM_PTR(&cv2_bitmask_type) }, \
+    /* Functions */ \
+    { MP_ROM_QSTR(MP_QSTR_inRangeBits), MP_ROM_PTR(&cv2_bitmask_inRangeBits_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_thresholdBits), MP_ROM_PTR(&cv2_bitmask_thresholdBits_obj) }
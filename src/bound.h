@@ -0,0 +1,89 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * bound.h
+ * 
+ * Bound operations, shared by cv2.bind() (see bind.cpp) and cv2.Pipeline (see
+ * pipeline.cpp).
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+
+// C headers
+extern "C" {
+#include "py/runtime.h"
+} // extern "C"
+
+using namespace cv;
+
+struct BoundOp;
+
+// A bound operation. The Mats only hold headers without a reference to their
+// data, so the object doesn't need a finaliser. The ndarrays behind them are
+// kept alive through dst_obj and objs
+struct cv2_bound_obj_t
+{
+    mp_obj_base_t base;
+    const BoundOp* op;
+    mp_obj_t dst_obj;
+    mp_obj_t objs[2];
+    Mat dst;
+    Mat mats[2];
+
+    // Converted arguments of each operation
+    union
+    {
+        struct { double thresh, maxval; int type; } threshold;
+        struct { int code; } cvtColor;
+        struct { int ksize[2], anchor[2], borderType; } blur;
+        struct { int ksize[2]; double sigmaX, sigmaY; int borderType, hint; } GaussianBlur;
+        struct { int ksize; } medianBlur;
+        struct { int op, anchor[2], iterations, borderType; double borderValue[4]; } morph;
+        struct { int mode, method, offset[2]; bool packed; } findContours;
+    } p;
+};
+
+// An operation that can be bound. args are the wrapper's arguments without
+// src, and bind() converts them. run() computes dst from src, and returns the
+// retval of functions that have one (eg. threshold()), which is returned along
+// with dst. Operations that don't output an image (eg. findContours()) have
+// finish() instead of run(), which returns the whole result, so they can only
+// be the last stage of a pipeline. halo() returns how many rows of src on each
+// side of a row are needed to compute that row of dst, or -1 if the bound
+// arguments rule out running on strips of rows. Operations without halo()
+// can't run on strips at all (see pipeline.cpp)
+struct BoundOp
+{
+    mp_fun_kw_t fun;
+    const mp_arg_t* args;
+    size_t n_args;
+    void (*bind)(cv2_bound_obj_t* self, const mp_arg_val_t* args);
+    double (*run)(cv2_bound_obj_t* self, const Mat& src, Mat& dst);
+    mp_obj_t (*finish)(cv2_bound_obj_t* self, const Mat& src);
+    int (*halo)(cv2_bound_obj_t* self);
+    bool has_retval;
+};
+
+// Binds the arguments in kw_args to fun, and returns the bound operation.
+// Raises a TypeError if fun can't be bound
+mp_obj_t bound_new(mp_obj_t fun, mp_map_t* kw_args);
+
+// Returns obj as a bound operation, or nullptr if it isn't one
+cv2_bound_obj_t* bound_from_mp_obj(mp_obj_t obj);
+
+// Converts src for a bound operation. Dense ndarrays only need a header, which
+// is only valid while the ndarray is
+Mat bound_src(mp_obj_t obj);
+
+// Runs a bound operation with run(). dst must be a header over the ndarray
+// dst_obj, or empty. If OpenCV has to reallocate dst (eg. src changed size),
+// the new data is allocated as an ndarray, and dst and dst_obj are updated
+double bound_run(cv2_bound_obj_t* self, const Mat& src, Mat& dst, mp_obj_t& dst_obj);
+
+// Returns what the unbound function would, given its dst and retval
+mp_obj_t bound_result(cv2_bound_obj_t* self, mp_obj_t dst_obj, double retval);
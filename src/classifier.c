@@ -0,0 +1,34 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * classifier.c
+ * 
+ * Type of cv2.ColorClassifier. The type is defined in C, since MicroPython's
+ * type macros don't compile as C++. Everything else is in classifier.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "classifier.h"
+
+// Defined in classifier.cpp
+extern mp_obj_t cv2_classifier_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args);
+extern mp_obj_t cv2_classifier_ColorClassifier_apply(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_classifier_ColorClassifier_apply_obj, 2, cv2_classifier_ColorClassifier_apply);
+
+static const mp_rom_map_elem_t cv2_classifier_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_apply), MP_ROM_PTR(&cv2_classifier_ColorClassifier_apply_obj) },
+};
+static MP_DEFINE_CONST_DICT(cv2_classifier_locals_dict, cv2_classifier_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    cv2_classifier_type,
+    MP_QSTR_ColorClassifier,
+    MP_TYPE_FLAG_NONE,
+    make_new, cv2_classifier_make_new,
+    locals_dict, &cv2_classifier_locals_dict
+    );
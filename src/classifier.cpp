@@ -0,0 +1,232 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * classifier.cpp
+ * 
+ * Color classification with a 3D lookup table. cv2.ColorClassifier(ranges)
+ * takes a list of (lower, upper) color ranges, and apply(frame) labels each
+ * pixel of a frame with the index of the range it's in, so finding several
+ * colors takes one pass over the frame instead of one inRange() per color.
+ * 
+ * The table has 32 bins per channel, which are the top 5 bits of each of B, G
+ * and R. Each bin's class is found once, when the classifier is created, by
+ * converting the color at the center of the bin (eg. to HSV) and checking it
+ * against the ranges, so classifying a pixel is just a table lookup. RGB565
+ * pixels index the table with their own bits, without unpacking them.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+#include "convert.h"
+#include "ops.h"
+#include "parallel.h"
+#include "profile_scope.h"
+
+// C headers
+extern "C" {
+#include "classifier.h"
+} // extern "C"
+
+using namespace cv;
+
+// Bits per channel of the table, and its number of entries
+#define CLASSIFIER_BITS 5
+#define CLASSIFIER_SIZE (1 << (3 * CLASSIFIER_BITS))
+
+// A color classifier. lut has the class of each color, indexed by
+// classifier_index()
+struct cv2_classifier_obj_t
+{
+    mp_obj_base_t base;
+    uchar* lut;
+};
+
+// Index into the table of a color, from the top bits of each channel
+static inline int classifier_index(int b5, int g5, int r5)
+{
+    return (b5 << (2 * CLASSIFIER_BITS)) | (g5 << CLASSIFIER_BITS) | r5;
+}
+
+// Classifies rows of 8-bit BGR (or BGRA) pixels
+static void classify_bgr(const uchar* lut, const Mat& src, Mat& dst)
+{
+    int cn = src.channels();
+    for(int y = 0; y < src.rows; y++)
+    {
+        const uchar* s = src.ptr<uchar>(y);
+        uchar* d = dst.ptr<uchar>(y);
+        for(int x = 0; x < src.cols; x++, s += cn)
+            d[x] = lut[classifier_index(s[0] >> 3, s[1] >> 3, s[2] >> 3)];
+    }
+}
+
+// Classifies rows of BGR565 pixels, in OpenCV's layout (blue in the low bits)
+static void classify_565(const uchar* lut, const Mat& src, Mat& dst)
+{
+    for(int y = 0; y < src.rows; y++)
+    {
+        const ushort* s = src.ptr<ushort>(y);
+        uchar* d = dst.ptr<uchar>(y);
+        for(int x = 0; x < src.cols; x++)
+        {
+            ushort t = s[x];
+            d[x] = lut[classifier_index(t & 31, (t >> 6) & 31, t >> 11)];
+        }
+    }
+}
+
+// Reads a bound of a range into 3 bytes
+static void classifier_bound(const Mat& bound, uchar* out)
+{
+    CV_Assert(bound.total() == 3 && bound.channels() == 1);
+    Mat b;
+    bound.reshape(1, 1).convertTo(b, CV_32S);
+    for(int c = 0; c < 3; c++)
+        out[c] = saturate_cast<uchar>(b.at<int>(c));
+}
+
+static cv2_classifier_obj_t* classifier_from_mp_obj(mp_obj_t obj)
+{
+    if(!mp_obj_is_type(obj, &cv2_classifier_type))
+        mp_raise_TypeError(MP_ERROR_TEXT("Expected a ColorClassifier"));
+    return (cv2_classifier_obj_t*) MP_OBJ_TO_PTR(obj);
+}
+
+extern "C" mp_obj_t cv2_classifier_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_ranges, ARG_code };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_ranges, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_code, MP_ARG_INT, { .u_int = COLOR_BGR2HSV } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t parsed[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, args, MP_ARRAY_SIZE(allowed_args), allowed_args, parsed);
+    int code = parsed[ARG_code].u_int;
+
+    // Assume the ranges are a list or tuple of (lower, upper) pairs. Will
+    // raise an exception if not
+    size_t n_ranges;
+    mp_obj_t *ranges;
+    mp_obj_get_array(parsed[ARG_ranges].u_obj, &n_ranges, &ranges);
+    if(n_ranges == 0 || n_ranges > 255)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("ColorClassifier needs 1 to 255 ranges"));
+    }
+    std::vector<Mat> bounds(2 * n_ranges);
+    for(size_t i = 0; i < n_ranges; i++)
+    {
+        size_t len;
+        mp_obj_t *pair;
+        mp_obj_get_array(ranges[i], &len, &pair);
+        if(len != 2)
+        {
+            mp_raise_ValueError(MP_ERROR_TEXT("ColorClassifier ranges must be (lower, upper) pairs"));
+        }
+        bounds[2 * i] = mp_obj_to_mat(pair[0]);
+        bounds[2 * i + 1] = mp_obj_to_mat(pair[1]);
+    }
+
+    cv2_classifier_obj_t *self = m_new_obj(cv2_classifier_obj_t);
+    self->base.type = type;
+    self->lut = m_new(uchar, CLASSIFIER_SIZE);
+
+    // Fill the table from the centers of the bins, converted to the color
+    // space of the ranges. The first range a color is in is its class, and
+    // colors that aren't in any are class 0. Like inRangeHSV(), a hue range
+    // wraps around if lower is above upper
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        std::vector<uchar> lo(3 * n_ranges), hi(3 * n_ranges);
+        for(size_t i = 0; i < n_ranges; i++)
+        {
+            classifier_bound(bounds[2 * i], &lo[3 * i]);
+            classifier_bound(bounds[2 * i + 1], &hi[3 * i]);
+        }
+        bool is_hsv = code == COLOR_BGR2HSV || code == COLOR_RGB2HSV;
+
+        Mat centers(1, CLASSIFIER_SIZE, CV_8UC3);
+        const int half = 1 << (7 - CLASSIFIER_BITS);
+        for(int b = 0; b < (1 << CLASSIFIER_BITS); b++)
+            for(int g = 0; g < (1 << CLASSIFIER_BITS); g++)
+                for(int r = 0; r < (1 << CLASSIFIER_BITS); r++)
+                {
+                    const int shift = 8 - CLASSIFIER_BITS;
+                    centers.at<Vec3b>(classifier_index(b, g, r)) = Vec3b((b << shift) | half, (g << shift) | half, (r << shift) | half);
+                }
+        Mat colors = centers;
+        if(code >= 0)
+            cvtColor(centers, colors, code);
+        CV_Assert(colors.type() == CV_8UC3 && colors.cols == CLASSIFIER_SIZE);
+
+        for(int i = 0; i < CLASSIFIER_SIZE; i++)
+        {
+            const Vec3b& c = colors.at<Vec3b>(i);
+            uchar cls = 0;
+            for(size_t k = 0; k < n_ranges && cls == 0; k++)
+            {
+                const uchar* l = &lo[3 * k];
+                const uchar* h = &hi[3 * k];
+                bool in0 = (is_hsv && l[0] > h[0]) ? (c[0] >= l[0] || c[0] <= h[0]) : (c[0] >= l[0] && c[0] <= h[0]);
+                if(in0 && c[1] >= l[1] && c[1] <= h[1] && c[2] >= l[2] && c[2] <= h[2])
+                    cls = (uchar) (k + 1);
+            }
+            self->lut[i] = cls;
+        }
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+extern "C" mp_obj_t cv2_classifier_ColorClassifier_apply(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    cv2_classifier_obj_t *self = classifier_from_mp_obj(pos_args[0]);
+
+    // Define the arguments
+    enum { ARG_frame, ARG_dst };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_frame, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat frame = mp_obj_to_mat(args[ARG_frame].u_obj);
+    Mat dst = mp_obj_to_mat(args[ARG_dst].u_obj);
+
+    // 8-bit frames with 3 or 4 channels are BGR, and 16-bit frames (or 8-bit
+    // ones with 2 channels, like OpenCV uses) are BGR565
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        int type = frame.type();
+        bool is_565 = type == CV_16UC1 || type == CV_8UC2;
+        CV_Assert(is_565 || type == CV_8UC3 || type == CV_8UC4);
+        dst.create(frame.size(), CV_8UC1);
+        const uchar* lut = self->lut;
+        parallel_pointwise(frame, dst, [&](Mat s, Mat d) {
+            if(is_565)
+                classify_565(lut, s, d);
+            else
+                classify_bgr(lut, s, d);
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return mat_to_mp_obj(dst);
+}
@@ -0,0 +1,22 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * classifier.h
+ * 
+ * MicroPython wrappers for color classification, see classifier.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Type definitions, see classifier.c
+extern const mp_obj_type_t cv2_classifier_type;
+
+// Global definitions for functions and constants
+#define OPENCV_CLASSIFIER_GLOBALS \
+    /* Types */ \
+    { MP_ROM_QSTR(MP_QSTR_ColorClassifier), MP_ROM_PTR(&cv2_classifier_type) }
@@ -0,0 +1,214 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * components.cpp
+ * 
+ * Connected component statistics computed in a single pass over the rows of an
+ * image, without a label image.
+ * 
+ * Each row is reduced to runs of foreground pixels, and each run is joined to
+ * the components of the runs it touches in the previous row with a union-find
+ * table, whose entries hold the statistics of their component. After each
+ * row, every run points at the root of its component. Roots that no run of
+ * the row points at can't grow any more, so their components are complete,
+ * and every other entry that isn't a root is no longer referenced. Both get
+ * reused, which bounds the table by the number of runs in two rows.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/imgproc.hpp"
+#include "components.h"
+#include <algorithm>
+
+ComponentLabeler::ComponentLabeler(int cols, int connectivity, uint32_t min_area)
+    : reach(connectivity == 8 ? 1 : 0), min_area(min_area), table(cols + 2)
+{
+    CV_Assert(connectivity == 4 || connectivity == 8);
+    free_labels.reserve(table.size());
+    for(int i = (int) table.size() - 1; i >= 0; i--)
+        free_labels.push_back(i);
+    live_labels.reserve(table.size());
+    prev_runs.reserve(cols / 2 + 1);
+    cur_runs.reserve(cols / 2 + 1);
+}
+
+int ComponentLabeler::find(int label)
+{
+    int root = label;
+    while(table[root].parent != root)
+        root = table[root].parent;
+    while(table[label].parent != root)
+    {
+        int next = table[label].parent;
+        table[label].parent = root;
+        label = next;
+    }
+    return root;
+}
+
+// Joins two roots, and returns the root of the result
+int ComponentLabeler::unite(int a, int b)
+{
+    ComponentStats& sa = table[a].stats;
+    const ComponentStats& sb = table[b].stats;
+    if(sb.top < sa.top || (sb.top == sa.top && sb.first_x < sa.first_x))
+        sa.first_x = sb.first_x;
+    sa.left = std::min(sa.left, sb.left);
+    sa.top = std::min(sa.top, sb.top);
+    sa.right = std::max(sa.right, sb.right);
+    sa.bottom = std::max(sa.bottom, sb.bottom);
+    sa.area += sb.area;
+    sa.sum_x += sb.sum_x;
+    sa.sum_y += sb.sum_y;
+    table[b].parent = a;
+    return a;
+}
+
+int ComponentLabeler::newEntry()
+{
+    // Can't happen, since the table has room for the runs of two rows
+    CV_Assert(!free_labels.empty());
+    int label = free_labels.back();
+    free_labels.pop_back();
+    live_labels.push_back(label);
+    table[label].parent = label;
+    table[label].stats.area = 0;
+    return label;
+}
+
+void ComponentLabeler::complete(int label)
+{
+    if(table[label].stats.area >= min_area)
+        components.push_back(table[label].stats);
+}
+
+void ComponentLabeler::addRow(int y, const int* runs, int n_runs)
+{
+    cur_runs.clear();
+    size_t p = 0;
+    for(int i = 0; i < n_runs; i++)
+    {
+        int x0 = runs[2 * i];
+        int x1 = runs[2 * i + 1];
+
+        // Join every run of the previous row that touches this one. Runs that
+        // end before this one starts can't touch the next one either
+        int label = -1;
+        while(p < prev_runs.size() && prev_runs[p].x1 + reach <= x0)
+            p++;
+        for(size_t q = p; q < prev_runs.size() && prev_runs[q].x0 < x1 + reach; q++)
+        {
+            int root = find(prev_runs[q].label);
+            if(label < 0)
+                label = root;
+            else if(root != label)
+                label = unite(label, root);
+        }
+
+        // Start a new component if none were touched
+        ComponentStats& s = table[label < 0 ? (label = newEntry()) : label].stats;
+        uint32_t len = x1 - x0;
+        if(s.area == 0)
+        {
+            s.left = x0;
+            s.right = x1 - 1;
+            s.top = s.bottom = y;
+            s.first_x = x0;
+            s.sum_x = s.sum_y = 0;
+        }
+        else
+        {
+            s.left = std::min(s.left, x0);
+            s.right = std::max(s.right, x1 - 1);
+            s.bottom = y;
+        }
+        s.area += len;
+        s.sum_x += (uint64_t) (x0 + x1 - 1) * len / 2;
+        s.sum_y += (uint64_t) y * len;
+        cur_runs.push_back({ x0, x1, label });
+    }
+
+    // Point every run at its root, then mark the roots with parent = -1 - root
+    // so the entries that are still needed can be told apart
+    for(Run& run : cur_runs)
+        run.label = find(run.label);
+    for(const Run& run : cur_runs)
+        table[run.label].parent = -1 - run.label;
+
+    // Complete the roots that weren't continued, and free everything but the
+    // marked roots
+    size_t n_live = 0;
+    for(int label : live_labels)
+    {
+        int parent = table[label].parent;
+        if(parent < 0)
+        {
+            table[label].parent = label;
+            live_labels[n_live++] = label;
+        }
+        else
+        {
+            if(parent == label)
+                complete(label);
+            free_labels.push_back(label);
+        }
+    }
+    live_labels.resize(n_live);
+    std::swap(prev_runs, cur_runs);
+}
+
+void ComponentLabeler::finish()
+{
+    for(int label : live_labels)
+    {
+        complete(label);
+        free_labels.push_back(label);
+    }
+    live_labels.clear();
+    prev_runs.clear();
+    std::sort(components.begin(), components.end(), [](const ComponentStats& a, const ComponentStats& b) {
+        return a.top < b.top || (a.top == b.top && a.first_x < b.first_x);
+    });
+}
+
+void row_runs(const uchar* row, int cols, std::vector<int>& runs)
+{
+    int x = 0;
+    while(x < cols)
+    {
+        while(x < cols && row[x] == 0)
+            x++;
+        if(x == cols)
+            break;
+        int x0 = x;
+        while(x < cols && row[x] != 0)
+            x++;
+        runs.push_back(x0);
+        runs.push_back(x);
+    }
+}
+
+void components_to_mats(const std::vector<ComponentStats>& components, Mat& stats, Mat& centroids)
+{
+    int n = (int) components.size();
+    if(n == 0)
+        return;
+    stats.create(n, CC_STAT_MAX, CV_32F);
+    centroids.create(n, 2, CV_32F);
+    for(int i = 0; i < n; i++)
+    {
+        const ComponentStats& c = components[i];
+        float* s = stats.ptr<float>(i);
+        s[CC_STAT_LEFT] = c.left;
+        s[CC_STAT_TOP] = c.top;
+        s[CC_STAT_WIDTH] = c.right - c.left + 1;
+        s[CC_STAT_HEIGHT] = c.bottom - c.top + 1;
+        s[CC_STAT_AREA] = c.area;
+        centroids.at<float>(i, 0) = (float) ((double) c.sum_x / c.area);
+        centroids.at<float>(i, 1) = (float) ((double) c.sum_y / c.area);
+    }
+}
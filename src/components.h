@@ -0,0 +1,81 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * components.h
+ * 
+ * Connected component statistics computed in a single pass over the rows of an
+ * image, without a label image.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+#include <vector>
+
+using namespace cv;
+
+// Statistics of one connected component. The bounds are inclusive, and first_x
+// is the leftmost pixel of the top row, which orders components like OpenCV
+// orders labels
+struct ComponentStats
+{
+    int left, top, right, bottom, first_x;
+    uint32_t area;
+    uint64_t sum_x, sum_y;
+};
+
+// Finds connected components from runs of foreground pixels, one row at a
+// time. Only the runs of the previous row are kept, and a component is moved
+// to components as soon as a row doesn't continue it, so the union-find table
+// never needs more than cols + 2 entries, no matter how many components the
+// image has
+class ComponentLabeler
+{
+public:
+    ComponentLabeler(int cols, int connectivity, uint32_t min_area);
+
+    // Adds row y, given as n_runs pairs of [x0, x1) sorted left to right
+    void addRow(int y, const int* runs, int n_runs);
+
+    // Completes the components that reach the last row, and sorts components
+    void finish();
+
+    // Completed components with at least min_area pixels
+    std::vector<ComponentStats> components;
+
+private:
+    struct Entry
+    {
+        int parent;
+        ComponentStats stats;
+    };
+    struct Run
+    {
+        int x0, x1, label;
+    };
+
+    int find(int label);
+    int unite(int a, int b);
+    int newEntry();
+    void complete(int label);
+
+    int reach;
+    uint32_t min_area;
+    std::vector<Entry> table;
+    std::vector<int> free_labels;
+    std::vector<int> live_labels;
+    std::vector<Run> prev_runs;
+    std::vector<Run> cur_runs;
+};
+
+// Appends the runs of nonzero pixels in a row of a CV_8UC1 image to runs, as
+// pairs of [x0, x1)
+void row_runs(const uchar* row, int cols, std::vector<int>& runs);
+
+// Writes the statistics of components into stats, in the layout of
+// connectedComponentsWithStats(), and their centroids into centroids, both as
+// CV_32F with one row per component. Leaves both empty if there are none
+void components_to_mats(const std::vector<ComponentStats>& components, Mat& stats, Mat& centroids);
@@ -19,8 +19,16 @@
 extern "C" {
 #include "ulab_tools.h"
 #include "py/obj.h"
+// Defined in alloc.c
+void* alloc_new_finaliser(void (*fn)(void* arg), void* arg);
+bool alloc_in_arena(const void* ptr);
 } // extern "C"
 
+// ulab's float arrays hold mp_float_t, which must be the same as CV_32F
+#if MICROPY_FLOAT_IMPL != MICROPY_FLOAT_IMPL_FLOAT
+#error "cv2 needs MICROPY_FLOAT_IMPL_FLOAT, so ulab's float arrays are CV_32F"
+#endif
+
 uint8_t mat_depth_to_ndarray_type(int depth)
 {
     switch (depth) {
@@ -45,6 +53,74 @@ int ndarray_type_to_mat_depth(uint8_t type)
     }
 }
 
+// Drops the reference to a Mat's data held by a wrapping ndarray, see
+// mat_wrap_ndarray(). This runs as a finaliser, so it must not throw
+static void mat_data_release(void* arg)
+{
+    UMatData* u = (UMatData*) arg;
+    try
+    {
+        if(CV_XADD(&u->refcount, -1) == 1)
+            u->currAllocator->unmap(u);
+    }
+    catch(...)
+    {
+    }
+}
+
+// Creates an ndarray that uses the data of a Mat from another allocator, rather
+// than a copy of it. The ndarray holds a reference to the Mat's data through a
+// finaliser object, which drops the reference once the ndarray (and any views
+// of it) are collected. ulab only uses the origin field to keep the data alive
+// for the GC, so the finaliser object goes there. Returns NULL if the Mat can't
+// be wrapped, so the caller has to copy it instead.
+//
+// Mats whose data or UMatData is in the scratch arena (see alloc.c) are copied
+// too. The ndarray would keep them alive until the GC collects it, and with
+// them the whole arena chunk they're in. PoolAllocator allocates its UMatData
+// outside the arena, so pooled Mats can still be wrapped
+static ndarray_obj_t *mat_wrap_ndarray(Mat& mat)
+{
+    if(!mat.u || mat.u->currAllocator == &GetNumpyAllocator() || (mat.u->flags & UMatData::USER_ALLOCATED))
+        return NULL;
+    if(alloc_in_arena(mat.u) || alloc_in_arena(mat.u->origdata))
+        return NULL;
+
+    int cn = mat.channels();
+    int ndim = mat.dims + (cn > 1 ? 1 : 0);
+    if(ndim > ULAB_MAX_DIMS)
+        return NULL;
+    uint8_t dtype = mat_depth_to_ndarray_type(mat.depth());
+
+    void* holder = alloc_new_finaliser(mat_data_release, mat.u);
+    if(holder == NULL)
+        return NULL;
+    CV_XADD(&mat.u->refcount, 1);
+
+    ndarray_obj_t *ndarray = m_new_obj(ndarray_obj_t);
+    ndarray->base.type = &ulab_ndarray_type;
+    ndarray->dtype = dtype;
+    ndarray->boolean = NDARRAY_NUMERIC;
+    ndarray->itemsize = mat.elemSize1();
+    ndarray->ndim = ndim;
+    ndarray->len = mat.total() * cn;
+    for (int i = 0; i < ULAB_MAX_DIMS; i++) {
+        ndarray->shape[i] = 0;
+        ndarray->strides[i] = 0;
+    }
+    for (int i = 0; i < mat.dims; i++) {
+        ndarray->shape[ULAB_MAX_DIMS - ndim + i] = mat.size[i];
+        ndarray->strides[ULAB_MAX_DIMS - ndim + i] = mat.step[i];
+    }
+    if (cn > 1) {
+        ndarray->shape[ULAB_MAX_DIMS - 1] = cn;
+        ndarray->strides[ULAB_MAX_DIMS - 1] = mat.elemSize1();
+    }
+    ndarray->array = mat.data;
+    ndarray->origin = holder;
+    return ndarray;
+}
+
 ndarray_obj_t *mat_to_ndarray(Mat& mat)
 {
     // Derived from:
@@ -54,6 +130,11 @@ ndarray_obj_t *mat_to_ndarray(Mat& mat)
     Mat temp, *ptr = (Mat*)&mat;
     if(!ptr->u || ptr->allocator != &GetNumpyAllocator())
     {
+        // Hand the existing data to Python if possible, instead of copying it
+        ndarray_obj_t *wrapped = mat_wrap_ndarray(mat);
+        if(wrapped != NULL)
+            return wrapped;
+
         temp.allocator = &GetNumpyAllocator();
         mat.copyTo(temp);
         ptr = &temp;
@@ -157,6 +238,74 @@ Mat ndarray_to_mat(ndarray_obj_t *ndarray)
     return mat;
 }
 
+Mat ndarray_to_mat_header(ndarray_obj_t *ndarray)
+{
+    if(!ndarray_is_dense(ndarray) || ndarray->ndim > 3)
+        return Mat();
+
+    // Same layout as ndarray_to_mat(), where 3D ndarrays are multi-channel
+    int type = ndarray_type_to_mat_depth(ndarray->dtype);
+    size_t *shape = &ndarray->shape[ULAB_MAX_DIMS - ndarray->ndim];
+    switch(ndarray->ndim)
+    {
+        case 1:
+            return Mat(shape[0], 1, type, ndarray->array);
+        case 2:
+            return Mat(shape[0], shape[1], type, ndarray->array);
+        default:
+            return Mat(shape[0], shape[1], CV_MAKETYPE(type, shape[2]), ndarray->array);
+    }
+}
+
+ndarray_obj_t *buffer_to_ndarray(mp_obj_t buffer, size_t offset, int ndim, const size_t *shape, uint8_t dtype)
+{
+    if(ndim < 1 || ndim > ULAB_MAX_DIMS)
+        mp_raise_ValueError(MP_ERROR_TEXT("Unsupported number of dimensions"));
+
+    // OpenCV may write to the Mat (eg. as a dst), so the buffer must be
+    // writable. Will raise an exception if obj has no buffer
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buffer, &bufinfo, MP_BUFFER_RW);
+
+    size_t itemsize = CV_ELEM_SIZE1(ndarray_type_to_mat_depth(dtype));
+    size_t len = 1;
+    for(int i = 0; i < ndim; i++)
+    {
+        // A product that wraps around could pass the size check below
+        if(shape[i] != 0 && len > SIZE_MAX / shape[i])
+            mp_raise_ValueError(MP_ERROR_TEXT("Buffer is too small for the shape"));
+        len *= shape[i];
+    }
+    if(offset > bufinfo.len || len > (bufinfo.len - offset) / itemsize)
+        mp_raise_ValueError(MP_ERROR_TEXT("Buffer is too small for the shape"));
+    uint8_t *array = (uint8_t*) bufinfo.buf + offset;
+    if((uintptr_t) array % itemsize != 0)
+        mp_raise_ValueError(MP_ERROR_TEXT("Buffer isn't aligned for the type"));
+
+    // Dense strides, like a new ndarray. ulab only uses the origin field to
+    // keep the data alive for the GC, so the buffer object goes there
+    ndarray_obj_t *ndarray = m_new_obj(ndarray_obj_t);
+    ndarray->base.type = &ulab_ndarray_type;
+    ndarray->dtype = dtype;
+    ndarray->boolean = NDARRAY_NUMERIC;
+    ndarray->itemsize = itemsize;
+    ndarray->ndim = ndim;
+    ndarray->len = len;
+    for (int i = 0; i < ULAB_MAX_DIMS; i++) {
+        ndarray->shape[i] = 0;
+        ndarray->strides[i] = 0;
+    }
+    int32_t stride = itemsize;
+    for (int i = ndim - 1; i >= 0; i--) {
+        ndarray->shape[ULAB_MAX_DIMS - ndim + i] = shape[i];
+        ndarray->strides[ULAB_MAX_DIMS - ndim + i] = stride;
+        stride *= shape[i];
+    }
+    ndarray->array = array;
+    ndarray->origin = MP_OBJ_TO_PTR(buffer);
+    return ndarray;
+}
+
 mp_obj_t mat_to_mp_obj(Mat &mat)
 {
     return MP_OBJ_FROM_PTR(mat_to_ndarray(mat));
@@ -184,59 +333,98 @@ Mat mp_obj_to_mat(mp_obj_t obj)
     return mat;
 }
 
-Size mp_obj_to_size(mp_obj_t obj)
+// Reads the values of a small argument like a Size, Point or Scalar into
+// values, and returns how many there are. Only the first max_len values are
+// read, so the caller must check the returned length. Tuples and lists are read
+// directly, and ndarrays are read in place, so trivial arguments like (5, 5)
+// don't need a temporary ndarray
+static size_t mp_obj_get_values(mp_obj_t obj, double *values, size_t max_len)
 {
-    // Check for None object
-    if(obj == mp_const_none)
+    // Single numbers, eg. a gray color
+    if(mp_obj_is_small_int(obj))
     {
-        // Create an empty Size object
-        return Size();
+        if(max_len > 0)
+            values[0] = MP_OBJ_SMALL_INT_VALUE(obj);
+        return 1;
+    }
+    if(mp_obj_is_float(obj))
+    {
+        if(max_len > 0)
+            values[0] = mp_obj_get_float(obj);
+        return 1;
     }
 
-    // Assume the object is a ndarray, or can be converted to one. Will raise an
-    // exception if not
-    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
-    
-    // Validate the length of the ndarray
-    if(ndarray->len != 2)
+    // Tuples and lists of numbers
+    if(mp_obj_is_type(obj, &mp_type_tuple) || mp_obj_is_type(obj, &mp_type_list))
     {
-        mp_raise_TypeError(MP_ERROR_TEXT("Size must be length 2"));
+        size_t len;
+        mp_obj_t *items;
+        mp_obj_get_array(obj, &len, &items);
+        for(size_t i = 0; i < len && i < max_len; i++)
+        {
+            if(mp_obj_is_small_int(items[i]))
+                values[i] = MP_OBJ_SMALL_INT_VALUE(items[i]);
+            else
+                values[i] = mp_obj_get_float(items[i]);
+        }
+        return len;
     }
 
-    // Compute the size, checking the type of the ndarray
-    Size size;
+    // Anything else is assumed to be a ndarray, or can be converted to one.
+    // Will raise an exception if not
+    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
+    size_t len = ndarray->len < max_len ? ndarray->len : max_len;
+    if(!ndarray_is_dense(ndarray))
+    {
+        // Views like a[::2] aren't contiguous, so read from a dense copy
+        ndarray = ndarray_from_mp_obj(ndarray_copy(ndarray), 0);
+    }
     switch(ndarray->dtype)
     {
         case NDARRAY_UINT8:
-            size.width = ((uint8_t*) ndarray->array)[0];
-            size.height = ((uint8_t*) ndarray->array)[1];
+            for(size_t i = 0; i < len; i++)
+                values[i] = ((uint8_t*) ndarray->array)[i];
             break;
         case NDARRAY_INT8:
-            size.width = ((int8_t*) ndarray->array)[0];
-            size.height = ((int8_t*) ndarray->array)[1];
+            for(size_t i = 0; i < len; i++)
+                values[i] = ((int8_t*) ndarray->array)[i];
             break;
         case NDARRAY_UINT16:
-            size.width = ((uint16_t*) ndarray->array)[0];
-            size.height = ((uint16_t*) ndarray->array)[1];
+            for(size_t i = 0; i < len; i++)
+                values[i] = ((uint16_t*) ndarray->array)[i];
             break;
         case NDARRAY_INT16:
-            size.width = ((int16_t*) ndarray->array)[0];
-            size.height = ((int16_t*) ndarray->array)[1];
+            for(size_t i = 0; i < len; i++)
+                values[i] = ((int16_t*) ndarray->array)[i];
             break;
         case NDARRAY_FLOAT:
-            size.width = ((float*) ndarray->array)[0];
-            size.height = ((float*) ndarray->array)[1];
-            break;
-        case NDARRAY_BOOL:
-            size.width = ((bool*) ndarray->array)[0];
-            size.height = ((bool*) ndarray->array)[1];
+            for(size_t i = 0; i < len; i++)
+                values[i] = ((float*) ndarray->array)[i];
             break;
         default:
             mp_raise_TypeError(MP_ERROR_TEXT("Unsupported ndarray type"));
             break;
     }
+    return ndarray->len;
+}
 
-    return size;
+Size mp_obj_to_size(mp_obj_t obj)
+{
+    // Check for None object
+    if(obj == mp_const_none)
+    {
+        // Create an empty Size object
+        return Size();
+    }
+
+    // Read the values, and validate the length
+    double values[2];
+    if(mp_obj_get_values(obj, values, 2) != 2)
+    {
+        mp_raise_TypeError(MP_ERROR_TEXT("Size must be length 2"));
+    }
+
+    return Size((int) values[0], (int) values[1]);
 }
 
 Size2f mp_obj_to_size2f(mp_obj_t obj)
@@ -248,50 +436,14 @@ Size2f mp_obj_to_size2f(mp_obj_t obj)
         return Size2f();
     }
 
-    // Assume the object is a ndarray, or can be converted to one. Will raise an
-    // exception if not
-    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
-    
-    // Validate the length of the ndarray
-    if(ndarray->len != 2)
+    // Read the values, and validate the length
+    double values[2];
+    if(mp_obj_get_values(obj, values, 2) != 2)
     {
         mp_raise_TypeError(MP_ERROR_TEXT("Size2f must be length 2"));
     }
 
-    // Compute the size, checking the type of the ndarray
-    Size2f size;
-    switch(ndarray->dtype)
-    {
-        case NDARRAY_UINT8:
-            size.width = ((uint8_t*) ndarray->array)[0];
-            size.height = ((uint8_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_INT8:
-            size.width = ((int8_t*) ndarray->array)[0];
-            size.height = ((int8_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_UINT16:
-            size.width = ((uint16_t*) ndarray->array)[0];
-            size.height = ((uint16_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_INT16:
-            size.width = ((int16_t*) ndarray->array)[0];
-            size.height = ((int16_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_FLOAT:
-            size.width = ((float*) ndarray->array)[0];
-            size.height = ((float*) ndarray->array)[1];
-            break;
-        case NDARRAY_BOOL:
-            size.width = ((bool*) ndarray->array)[0];
-            size.height = ((bool*) ndarray->array)[1];
-            break;
-        default:
-            mp_raise_TypeError(MP_ERROR_TEXT("Unsupported ndarray type"));
-            break;
-    }
-
-    return size;
+    return Size2f(values[0], values[1]);
 }
 
 Point mp_obj_to_point(mp_obj_t obj)
@@ -303,50 +455,15 @@ Point mp_obj_to_point(mp_obj_t obj)
         return Point();
     }
 
-    // Assume the object is a ndarray, or can be converted to one. Will raise an
-    // exception if not
-    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
-    
-    // Validate the length of the ndarray
-    if(ndarray->len != 2)
+    // Read the values, and validate the length
+    double values[2];
+    if(mp_obj_get_values(obj, values, 2) != 2)
     {
         mp_raise_TypeError(MP_ERROR_TEXT("Point must be length 2"));
     }
 
-    // Compute the point, checking the type of the ndarray
-    Point point;
-    switch(ndarray->dtype)
-    {
-        case NDARRAY_UINT8:
-            point.x = ((uint8_t*) ndarray->array)[0];
-            point.y = ((uint8_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_INT8:
-            point.x = ((int8_t*) ndarray->array)[0];
-            point.y = ((int8_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_UINT16:
-            point.x = ((uint16_t*) ndarray->array)[0];
-            point.y = ((uint16_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_INT16:
-            point.x = ((int16_t*) ndarray->array)[0];
-            point.y = ((int16_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_FLOAT:
-            point.x = ((float*) ndarray->array)[0];
-            point.y = ((float*) ndarray->array)[1];
-            break;
-        case NDARRAY_BOOL:
-            point.x = ((bool*) ndarray->array)[0];
-            point.y = ((bool*) ndarray->array)[1];
-            break;
-        default:
-            mp_raise_TypeError(MP_ERROR_TEXT("Unsupported ndarray type"));
-            break;
-    }
-
-    return point;
+    // Truncate rather than round, as when reading from a float ndarray
+    return Point((int) values[0], (int) values[1]);
 }
 
 Point2f mp_obj_to_point2f(mp_obj_t obj)
@@ -358,50 +475,14 @@ Point2f mp_obj_to_point2f(mp_obj_t obj)
         return Point2f();
     }
 
-    // Assume the object is a ndarray, or can be converted to one. Will raise an
-    // exception if not
-    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
-
-    // Validate the length of the ndarray
-    if(ndarray->len != 2)
+    // Read the values, and validate the length
+    double values[2];
+    if(mp_obj_get_values(obj, values, 2) != 2)
     {
         mp_raise_TypeError(MP_ERROR_TEXT("Point2f must be length 2"));
     }
 
-    // Compute the point, checking the type of the ndarray
-    Point2f point;
-    switch(ndarray->dtype)
-    {
-        case NDARRAY_UINT8:
-            point.x = ((uint8_t*) ndarray->array)[0];
-            point.y = ((uint8_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_INT8:
-            point.x = ((int8_t*) ndarray->array)[0];
-            point.y = ((int8_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_UINT16:
-            point.x = ((uint16_t*) ndarray->array)[0];
-            point.y = ((uint16_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_INT16:
-            point.x = ((int16_t*) ndarray->array)[0];
-            point.y = ((int16_t*) ndarray->array)[1];
-            break;
-        case NDARRAY_FLOAT:
-            point.x = ((float*) ndarray->array)[0];
-            point.y = ((float*) ndarray->array)[1];
-            break;
-        case NDARRAY_BOOL:
-            point.x = ((bool*) ndarray->array)[0];
-            point.y = ((bool*) ndarray->array)[1];
-            break;
-        default:
-            mp_raise_TypeError(MP_ERROR_TEXT("Unsupported ndarray type"));
-            break;
-    }
-
-    return point;
+    return Point2f(values[0], values[1]);
 }
 
 Scalar mp_obj_to_scalar(mp_obj_t obj)
@@ -413,94 +494,278 @@ Scalar mp_obj_to_scalar(mp_obj_t obj)
         return Scalar();
     }
 
-    // Assume the object is a ndarray, or can be converted to one. Will raise an
-    // exception if not
-    ndarray_obj_t *ndarray = ndarray_from_mp_obj(obj, 0);
-    
-    // Validate the length of the ndarray
-    if(ndarray->len > 4)
+    // Read the values, and validate the length
+    Scalar scalar;
+    if(mp_obj_get_values(obj, scalar.val, 4) > 4)
     {
         mp_raise_TypeError(MP_ERROR_TEXT("Scalar must be length 4 or less"));
     }
 
-    // Compute the scalar, checking the type of the ndarray
-    Scalar scalar;
-    switch(ndarray->dtype)
+    return scalar;
+}
+
+Mat mp_obj_to_points(mp_obj_t obj)
+{
+    Mat points = mp_obj_to_mat(obj);
+    if(!points.empty() && points.depth() != CV_32F)
     {
-        case NDARRAY_UINT8:
-            for(size_t i = 0; i < ndarray->len; i++)
-                scalar[i] = ((uint8_t*) ndarray->array)[i];
-            break;
-        case NDARRAY_INT8:
-            for(size_t i = 0; i < ndarray->len; i++)
-                scalar[i] = ((int8_t*) ndarray->array)[i];
-            break;
-        case NDARRAY_UINT16:
-            for(size_t i = 0; i < ndarray->len; i++)
-                scalar[i] = ((uint16_t*) ndarray->array)[i];
-            break;
-        case NDARRAY_INT16:
-            for(size_t i = 0; i < ndarray->len; i++)
-                scalar[i] = ((int16_t*) ndarray->array)[i];
-            break;
-        case NDARRAY_FLOAT:
-            for(size_t i = 0; i < ndarray->len; i++)
-                scalar[i] = ((float*) ndarray->array)[i];
-            break;
-        case NDARRAY_BOOL:
-            for(size_t i = 0; i < ndarray->len; i++)
-                scalar[i] = ((bool*) ndarray->array)[i];
-            break;
-        default:
-            mp_raise_TypeError(MP_ERROR_TEXT("Unsupported ndarray type"));
-            break;
+        Mat points_f32;
+        points.convertTo(points_f32, CV_32F);
+        return points_f32;
     }
+    return points;
+}
 
-    return scalar;
+bool mp_obj_is_packed_contours(mp_obj_t obj)
+{
+    // Packed contours are a tuple of a 2D ndarray and a 1D ndarray. Contours
+    // in a sequence are always at least 2D, so this is never ambiguous
+    if(!mp_obj_is_type(obj, &mp_type_tuple))
+        return false;
+    mp_obj_tuple_t *tuple = (mp_obj_tuple_t*) MP_OBJ_TO_PTR(obj);
+    if(tuple->len != 2 || !mp_obj_is_type(tuple->items[0], &ulab_ndarray_type)
+        || !mp_obj_is_type(tuple->items[1], &ulab_ndarray_type))
+        return false;
+    ndarray_obj_t *points = (ndarray_obj_t*) MP_OBJ_TO_PTR(tuple->items[0]);
+    ndarray_obj_t *offsets = (ndarray_obj_t*) MP_OBJ_TO_PTR(tuple->items[1]);
+    return points->ndim == 2 && offsets->ndim == 1;
 }
 
-std::vector<std::vector<Point>> mp_obj_to_contours(mp_obj_t obj)
+// Reads packed contours, see mp_obj_to_contours(). All points are converted to
+// CV_32S in one go, and each contour is a view of its rows
+static std::vector<Mat> packed_mp_obj_to_contours(mp_obj_t obj)
+{
+    mp_obj_tuple_t *tuple = (mp_obj_tuple_t*) MP_OBJ_TO_PTR(obj);
+    Mat points = mp_obj_to_mat(tuple->items[0]);
+    Mat offsets = mp_obj_to_mat(tuple->items[1]);
+    if(points.cols != 2)
+    {
+        mp_raise_TypeError(MP_ERROR_TEXT("Packed points must be Nx2"));
+    }
+
+    Mat points32S, offsets32S;
+    points.reshape(2, points.rows).convertTo(points32S, CV_32S);
+    offsets.reshape(1, 1).convertTo(offsets32S, CV_32S);
+
+    int ncontours = offsets32S.cols - 1;
+    std::vector<Mat> contours(ncontours > 0 ? ncontours : 0);
+    for (int i = 0; i < ncontours; i++)
+    {
+        int start = offsets32S.at<int>(i);
+        int end = offsets32S.at<int>(i + 1);
+        if(start < 0 || end < start || end > points32S.rows)
+        {
+            mp_raise_ValueError(MP_ERROR_TEXT("Packed offsets out of range"));
+        }
+        contours[i] = points32S.rowRange(start, end);
+    }
+    return contours;
+}
+
+// Creates a Mat header over the points of a contour ndarray, as a column of
+// 2-channel points. Dense ndarrays are used directly, without going through
+// ndarray_to_mat(), since the header only needs to live until the points have
+// been converted
+static Mat contour_ndarray_to_points(ndarray_obj_t *ndarray)
+{
+    if(ndarray->len % 2 != 0)
+    {
+        mp_raise_TypeError(MP_ERROR_TEXT("Contour points must be length 2"));
+    }
+    int npoints = ndarray->len / 2;
+    if(ndarray_is_dense(ndarray))
+    {
+        int depth = ndarray_type_to_mat_depth(ndarray->dtype);
+        return Mat(npoints, 1, CV_MAKETYPE(depth, 2), ndarray->array);
+    }
+    Mat points = ndarray_to_mat(ndarray);
+    if(!points.isContinuous())
+        points = points.clone();
+    return points.reshape(2, npoints);
+}
+
+void contours_to_packed_mp_obj(const std::vector<std::vector<Point>>& contours, mp_obj_t* points, mp_obj_t* offsets)
+{
+    // The offsets are uint16, since ulab has no 32-bit integer type
+    size_t total = 0;
+    for (size_t i = 0; i < contours.size(); i++)
+        total += contours[i].size();
+    if(total > UINT16_MAX)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Too many contour points to pack"));
+    }
+
+    size_t shape[ULAB_MAX_DIMS] = {};
+    shape[ULAB_MAX_DIMS - 2] = total;
+    shape[ULAB_MAX_DIMS - 1] = 2;
+    ndarray_obj_t *points_ndarray = ndarray_new_dense_ndarray(2, shape, NDARRAY_INT16);
+    ndarray_obj_t *offsets_ndarray = ndarray_new_linear_array(contours.size() + 1, NDARRAY_UINT16);
+
+    int16_t *p = (int16_t*) points_ndarray->array;
+    uint16_t *o = (uint16_t*) offsets_ndarray->array;
+    size_t n = 0;
+    for (size_t i = 0; i < contours.size(); i++)
+    {
+        o[i] = n;
+        for (const Point& pt : contours[i])
+        {
+            *p++ = saturate_cast<int16_t>(pt.x);
+            *p++ = saturate_cast<int16_t>(pt.y);
+        }
+        n += contours[i].size();
+    }
+    o[contours.size()] = n;
+
+    *points = MP_OBJ_FROM_PTR(points_ndarray);
+    *offsets = MP_OBJ_FROM_PTR(offsets_ndarray);
+}
+
+std::vector<Mat> mp_obj_to_contours(mp_obj_t obj)
 {
     // Check for None object
     if(obj == mp_const_none)
     {
         // Create an empty contours object
-        return std::vector<std::vector<Point>>();
+        return std::vector<Mat>();
     }
-    
-    // Create a vector to hold the contours
-    std::vector<std::vector<Point>> contours;
 
-    // Ideally, we could just use ndarray_from_mp_obj(), but it has a bug with
-    // 4D arrays, so we need to do this a bit manually.
+    // Check for packed contours
+    if(mp_obj_is_packed_contours(obj))
+    {
+        return packed_mp_obj_to_contours(obj);
+    }
+
+    // Ideally, we could just use ndarray_from_mp_obj() on the whole object,
+    // but it has a bug with 4D arrays, so we need to do this a bit manually.
     // https://github.com/v923z/micropython-ulab/issues/727
     
-    // Assume the object is iterable. Will raise an exception if not
-    mp_obj_iter_buf_t iter_buf;
-    mp_obj_t iterable = mp_getiter(obj, &iter_buf);
-    mp_obj_t item;
-
-    // Iterate through all items in the iterable
-    while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION)
-    {
-        // Create a vector to hold the points of this contour
-        std::vector<Point> contour;
-        
-        // Convert the item to a Mat object (should be a 3D ndarray of points)
-        Mat contour_mat = mp_obj_to_mat(item);
-
-        // Iterate through the rows of the Mat object and extract the points
-        for (int j = 0; j < contour_mat.rows; j++)
+    // Assume the object is a sequence of contours. Will raise an exception if
+    // not
+    size_t ncontours;
+    mp_obj_t *items;
+    mp_obj_t list = MP_OBJ_NULL;
+    if(mp_obj_is_type(obj, &mp_type_tuple) || mp_obj_is_type(obj, &mp_type_list))
+    {
+        mp_obj_get_array(obj, &ncontours, &items);
+    }
+    else
+    {
+        list = mp_obj_new_list(0, NULL);
+        mp_obj_iter_buf_t iter_buf;
+        mp_obj_t iterable = mp_getiter(obj, &iter_buf);
+        mp_obj_t item;
+        while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION)
+            mp_obj_list_append(list, item);
+        mp_obj_get_array(list, &ncontours, &items);
+    }
+
+    // Count the points first, so every contour can be converted into a single
+    // CV_32S buffer, instead of allocating a vector of points per contour
+    std::vector<ndarray_obj_t*> ndarrays(ncontours);
+    int total = 0;
+    for (size_t i = 0; i < ncontours; i++)
+    {
+        ndarrays[i] = ndarray_from_mp_obj(items[i], 0);
+        total += ndarrays[i]->len / 2;
+    }
+
+    Mat points32S(total, 1, CV_32SC2);
+    std::vector<Mat> contours(ncontours);
+    int start = 0;
+    for (size_t i = 0; i < ncontours; i++)
+    {
+        Mat points = contour_ndarray_to_points(ndarrays[i]);
+        Mat dst = points32S.rowRange(start, start + points.rows);
+        if(points.depth() == CV_16S && points.rows > 0)
         {
-            contour.push_back(Point(
-                contour_mat.at<float>(j, 0),
-                contour_mat.at<float>(j, 1)
-            ));
+            // Integer points (eg. slices of packed contours) just need to be
+            // widened, which is cheaper than a generic conversion
+            const int16_t *s = points.ptr<int16_t>(0);
+            int *d = dst.ptr<int>(0);
+            for (int j = 0; j < points.rows * 2; j++)
+                d[j] = s[j];
         }
-
-        // Add the contour to the list of contours
-        contours.push_back(contour);
+        else if(points.depth() == CV_32F && points.rows > 0)
+        {
+            // convertTo() rounds, but float points have always been truncated
+            // (like mp_obj_to_point()), so cast each coordinate instead
+            if(!points.isContinuous())
+                points = points.clone();
+            const float *s = points.ptr<float>(0);
+            int *d = dst.ptr<int>(0);
+            for (int j = 0; j < points.rows * 2; j++)
+                d[j] = (int) s[j];
+        }
+        else
+        {
+            points.convertTo(dst, CV_32S);
+        }
+        contours[i] = dst;
+        start += points.rows;
     }
 
     return contours;
 }
+
+mp_obj_t contours_to_mp_obj(const std::vector<std::vector<Point>>& contours, const std::vector<Vec4i>& hierarchy, bool packed)
+{
+    // Convert hierarchy to an ndarray
+    Mat mat_hierarchy(hierarchy);
+    Mat mat_16s;
+    mat_hierarchy.convertTo(mat_16s, CV_16S);
+
+    // Packed contours are all returned in a single ndarray of int16 points,
+    // plus an ndarray of offsets to the start of each contour
+    if(packed) {
+        mp_obj_t result_tuple[3];
+        contours_to_packed_mp_obj(contours, &result_tuple[0], &result_tuple[1]);
+        result_tuple[2] = mat_to_mp_obj(mat_16s);
+        return mp_obj_new_tuple(3, result_tuple);
+    }
+
+    // Convert contours to a tuple of ndarray objects
+    mp_obj_t contours_obj = mp_obj_new_tuple(contours.size(), NULL);
+    mp_obj_tuple_t *contours_tuple = (mp_obj_tuple_t*) MP_OBJ_TO_PTR(contours_obj);
+    
+    for(size_t i = 0; i < contours.size(); i++) {
+        Mat mat_contour(contours[i]);
+        Mat mat_f32;
+        mat_contour.convertTo(mat_f32, CV_32F);
+        contours_tuple->items[i] = mat_to_mp_obj(mat_f32);
+    }
+
+    mp_obj_t result_tuple[2];
+    result_tuple[0] = contours_obj;
+    result_tuple[1] = mat_to_mp_obj(mat_16s);
+    return mp_obj_new_tuple(2, result_tuple);
+}
+
+mp_obj_t moments_to_mp_obj(const Moments& moments)
+{
+    mp_obj_t moments_dict = mp_obj_new_dict(0);
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m00), mp_obj_new_float(moments.m00));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m10), mp_obj_new_float(moments.m10));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m01), mp_obj_new_float(moments.m01));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m20), mp_obj_new_float(moments.m20));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m11), mp_obj_new_float(moments.m11));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m02), mp_obj_new_float(moments.m02));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m30), mp_obj_new_float(moments.m30));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m21), mp_obj_new_float(moments.m21));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m12), mp_obj_new_float(moments.m12));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m03), mp_obj_new_float(moments.m03));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu20), mp_obj_new_float(moments.mu20));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu11), mp_obj_new_float(moments.mu11));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu02), mp_obj_new_float(moments.mu02));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu30), mp_obj_new_float(moments.mu30));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu21), mp_obj_new_float(moments.mu21));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu12), mp_obj_new_float(moments.mu12));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu03), mp_obj_new_float(moments.mu03));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu20), mp_obj_new_float(moments.nu20));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu11), mp_obj_new_float(moments.nu11));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu02), mp_obj_new_float(moments.nu02));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu30), mp_obj_new_float(moments.nu30));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu21), mp_obj_new_float(moments.nu21));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu12), mp_obj_new_float(moments.nu12));
+    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu03), mp_obj_new_float(moments.nu03));
+    return moments_dict;
+}
@@ -30,6 +30,20 @@ int ndarray_type_to_mat_depth(uint8_t type);
 ndarray_obj_t *mat_to_ndarray(Mat &mat);
 Mat ndarray_to_mat(ndarray_obj_t *ndarray);
 
+// Creates a Mat header over the data of a dense ndarray, without allocating
+// anything or holding a reference to the ndarray. The caller must keep the
+// ndarray alive while the Mat is used, and must not pass the Mat to
+// mat_to_ndarray(), which would copy it. Returns an empty Mat if the ndarray
+// isn't dense, or has more than 3 dimensions
+Mat ndarray_to_mat_header(ndarray_obj_t *ndarray);
+
+// Creates a dense ndarray over the memory of an object with the buffer protocol
+// (eg. a bytearray filled by a camera driver), starting offset bytes in,
+// without copying it. The ndarray keeps the object alive, and Mats from
+// ndarray_to_mat() of it use the same memory. Raises an exception if the buffer
+// isn't writable, is too small, or isn't aligned for dtype
+ndarray_obj_t *buffer_to_ndarray(mp_obj_t buffer, size_t offset, int ndim, const size_t *shape, uint8_t dtype);
+
 // Conversion functions between Mat and mp_obj_t. Abstracts away intermediate
 // conversions to ndarray_obj_t
 mp_obj_t mat_to_mp_obj(Mat &mat);
@@ -46,5 +60,23 @@ Point2f mp_obj_to_point2f(mp_obj_t obj);
 // Conversion functions between Scalar and mp_obj_t
 Scalar mp_obj_to_scalar(mp_obj_t obj);
 
-// Conversion functions between contours (vector of vector of Point) and mp_obj_t
-std::vector<std::vector<Point>> mp_obj_to_contours(mp_obj_t obj);
+// Conversion function from a point set (eg. a single contour) to Mat. Points
+// that aren't float (eg. the int16 points from packed contours) are converted
+// to float, because OpenCV's point set functions need CV_32F or CV_32S
+Mat mp_obj_to_points(mp_obj_t obj);
+
+// Conversion functions between contours and mp_obj_t. Contours are either a
+// sequence of ndarrays, or packed as a tuple of (points, offsets), where points
+// is an Nx2 int16 ndarray with the points of every contour, and contour i is
+// points[offsets[i]:offsets[i+1]]. Input contours are returned as CV_32SC2 Mat
+// headers into a single buffer, for use as InputArrayOfArrays
+std::vector<Mat> mp_obj_to_contours(mp_obj_t obj);
+bool mp_obj_is_packed_contours(mp_obj_t obj);
+void contours_to_packed_mp_obj(const std::vector<std::vector<Point>>& contours, mp_obj_t* points, mp_obj_t* offsets);
+
+// Conversion function from the output of findContours() to the tuple it returns
+// in Python, with packed or unpacked contours
+mp_obj_t contours_to_mp_obj(const std::vector<std::vector<Point>>& contours, const std::vector<Vec4i>& hierarchy, bool packed);
+
+// Conversion function from Moments to the dictionary moments() returns
+mp_obj_t moments_to_mp_obj(const Moments& moments);
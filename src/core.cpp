@@ -15,11 +15,16 @@
 #include "opencv2/imgcodecs.hpp"
 #include "convert.h"
 #include "numpy.h"
+#include "ops.h"
+#include "parallel.h"
+#include "pool_allocator.h"
+#include "profile_scope.h"
 
 // C headers
 extern "C" {
 #include "core.h"
 #include "ndarray.h"
+#include "upyhal.h"
 } // extern "C"
 
 using namespace cv;
@@ -66,6 +71,16 @@ bool upyOpenCVBoot() {
         // `__wrap_malloc()` to ensure the data is allocated on the GC heap
         Mat::getDefaultAllocator();
 
+        // Sets the pooling allocator as the default, so temporaries that get
+        // allocated every frame reuse the buffers from the previous frame. It
+        // gets buffers the same way StdMatAllocator does, so the above still
+        // applies. The allocator object itself must be on the C heap too
+        Mat::setDefaultAllocator(&GetPoolAllocator());
+
+        // Registers the parallel_for_() backend that uses both cores. The
+        // backend object needs to be on the C heap for the same reasons
+        upyParallelInit();
+
         return true;
     } catch (const Exception& e) {
         return false;
@@ -73,7 +88,46 @@ bool upyOpenCVBoot() {
 }
 volatile bool bootSuccess = upyOpenCVBoot();
 
+// Lookup table for convertScaleAbs() of an 8-bit image. Each entry is computed
+// exactly like OpenCV's own 8-bit kernel does it, so the results are identical
+static Mat convert_scale_abs_lut(double alpha, double beta)
+{
+    Mat lut(1, 256, CV_8U);
+    float a = (float)alpha, b = (float)beta;
+    for(int i = 0; i < 256; i++)
+        lut.at<uchar>(i) = saturate_cast<uchar>(std::abs(i * a + b));
+    return lut;
+}
+
+// Converts inRange() bounds for an 8-bit image to bytes, the same way
+// cv::inRange() does. Returns false unless both bounds have one value per
+// channel, in which case OpenCV handles them instead
+static bool inrange_bounds_8u(const Mat& lower, const Mat& upper, int cn, uchar* lo, uchar* hi)
+{
+    if(cn > 4 || lower.total() != (size_t)cn || upper.total() != (size_t)cn ||
+       lower.channels() != 1 || upper.channels() != 1 ||
+       !lower.isContinuous() || !upper.isContinuous())
+        return false;
+
+    Mat l, u;
+    lower.reshape(1, 1).convertTo(l, CV_32S);
+    upper.reshape(1, 1).convertTo(u, CV_32S);
+    for(int c = 0; c < cn; c++) {
+        int a = l.at<int>(c), b = u.at<int>(c);
+        // An impossible range never matches
+        if(a > b || a > 255 || b < 0) {
+            a = 1;
+            b = 0;
+        }
+        lo[c] = saturate_cast<uchar>(a);
+        hi[c] = saturate_cast<uchar>(b);
+    }
+    return true;
+}
+
 mp_obj_t cv2_core_convertScaleAbs(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_dst, ARG_alpha, ARG_beta };
     static const mp_arg_t allowed_args[] = {
@@ -94,17 +148,131 @@ mp_obj_t cv2_core_convertScaleAbs(size_t n_args, const mp_obj_t *pos_args, mp_ma
     mp_float_t beta = args[ARG_beta].u_obj == mp_const_none ? 0.0 : mp_obj_get_float(args[ARG_beta].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        convertScaleAbs(src, dst, alpha, beta);
+        dst.create(src.size(), CV_8UC(src.channels()));
+        if(src.depth() == CV_8U) {
+            // 8-bit images only have 256 possible values, so compute each one
+            // once, the same way OpenCV does, and look them up
+            Mat lut = convert_scale_abs_lut(alpha, beta);
+            parallel_pointwise(src, dst, [&](Mat s, Mat d) {
+                LUT(s, lut, d);
+            });
+        } else {
+            parallel_pointwise(src, dst, [&](Mat s, Mat d) {
+                convertScaleAbs(s, d, alpha, beta);
+            });
+        }
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
+mp_obj_t cv2_core_frombuffer(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_buffer, ARG_shape, ARG_type, ARG_offset };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_buffer, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_shape, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_type, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
+        { MP_QSTR_offset, MP_ARG_INT, { .u_int = 0 } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    int type = args[ARG_type].u_int;
+    int cn = CV_MAT_CN(type);
+    uint8_t dtype = mat_depth_to_ndarray_type(CV_MAT_DEPTH(type));
+    if(args[ARG_offset].u_int < 0)
+        mp_raise_ValueError(MP_ERROR_TEXT("offset must not be negative"));
+
+    // The shape is (rows, cols[, channels]), or (len,). Channels can be left
+    // out if the type has them, or given with a single channel type, like a
+    // ndarray's shape
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_get_array(args[ARG_shape].u_obj, &len, &items);
+    if(len < 1 || len > 3)
+        mp_raise_ValueError(MP_ERROR_TEXT("shape must have 1 to 3 dimensions"));
+    size_t shape[3];
+    for(size_t i = 0; i < len; i++)
+    {
+        mp_int_t size = mp_obj_get_int(items[i]);
+        if(size <= 0)
+            mp_raise_ValueError(MP_ERROR_TEXT("shape must be positive"));
+        shape[i] = size;
+    }
+    if(len == 3 && cn > 1 && shape[2] != (size_t) cn)
+        mp_raise_ValueError(MP_ERROR_TEXT("shape doesn't match the channels of type"));
+    if(len < 3 && cn > 1)
+    {
+        if(len == 1)
+            shape[len++] = 1;
+        shape[len++] = cn;
+    }
+
+    // Return a ndarray over the buffer. mp_obj_to_mat() makes a Mat header
+    // over the same memory, so nothing is copied
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return MP_OBJ_FROM_PTR(buffer_to_ndarray(args[ARG_buffer].u_obj, args[ARG_offset].u_int, len, shape, dtype));
+}
+
+InRangeBounds op_inRange_bounds(Size size, int type, const Mat& lower, const Mat& upper)
+{
+    InRangeBounds bounds;
+    bounds.lower = lower;
+    bounds.upper = upper;
+    bounds.lower_rows = lower.size() == size;
+    bounds.upper_rows = upper.size() == size;
+    bounds.packed = CV_MAT_DEPTH(type) == CV_8U && inrange_bounds_8u(lower, upper, CV_MAT_CN(type), bounds.lo, bounds.hi);
+    return bounds;
+}
+
+void op_inRange_row(const InRangeBounds& bounds, const Mat& src, int y, Mat& dst)
+{
+    // Bounds that are arrays the same size as the image are sliced to the
+    // same row
+    if(bounds.packed) {
+        dst.create(src.size(), CV_8UC1);
+        upyhal_inRange8u(src.data, src.step, dst.data, dst.step, src.cols, src.rows, src.channels(), bounds.lo, bounds.hi);
+    } else {
+        inRange(src, bounds.lower_rows ? bounds.lower.row(y) : bounds.lower, bounds.upper_rows ? bounds.upper.row(y) : bounds.upper, dst);
+    }
+}
+
+void op_inRange(const Mat& src, const Mat& lower, const Mat& upper, Mat& dst)
+{
+    // The bounds can be arrays the same size as src, which would need to be
+    // split into bands too, so only split the work when they're scalars
+    if(lower.size() != src.size() && upper.size() != src.size()) {
+        dst.create(src.size(), CV_8UC1);
+
+        // 8-bit images with one bound per channel use the packed kernel
+        uchar lo[4], hi[4];
+        bool packed = src.depth() == CV_8U && inrange_bounds_8u(lower, upper, src.channels(), lo, hi);
+        parallel_pointwise(src, dst, [&](Mat s, Mat d) {
+            if(packed)
+                upyhal_inRange8u(s.data, s.step, d.data, d.step, s.cols, s.rows, s.channels(), lo, hi);
+            else
+                inRange(s, lower, upper, d);
+        });
+    } else {
+        inRange(src, lower, upper, dst);
+    }
+}
+
 mp_obj_t cv2_core_inRange(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_lower, ARG_upper, ARG_dst };
     static const mp_arg_t allowed_args[] = {
@@ -125,17 +293,76 @@ mp_obj_t cv2_core_inRange(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
     Mat dst = mp_obj_to_mat(args[ARG_dst].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        inRange(src, lower, upper, dst);
+        op_inRange(src, lower, upper, dst);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return mat_to_mp_obj(dst);
+}
+
+// Converts an inRangeHSV() bound to bytes. Unlike inRange(), lower can be above
+// upper, since the hue range wraps around
+static void hsv_bound(const Mat& bound, uchar* out)
+{
+    CV_Assert(bound.total() == 3 && bound.channels() == 1);
+    Mat b;
+    bound.reshape(1, 1).convertTo(b, CV_32S);
+    for(int c = 0; c < 3; c++)
+        out[c] = saturate_cast<uchar>(b.at<int>(c));
+}
+
+mp_obj_t cv2_core_inRangeHSV(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_src, ARG_lower, ARG_upper, ARG_dst };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_lower, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_upper, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat src = mp_obj_to_mat(args[ARG_src].u_obj);
+    Mat lower = mp_obj_to_mat(args[ARG_lower].u_obj);
+    Mat upper = mp_obj_to_mat(args[ARG_upper].u_obj);
+    Mat dst = mp_obj_to_mat(args[ARG_dst].u_obj);
+
+    // Same as cvtColor(src, COLOR_BGR2HSV) followed by inRange(), but each
+    // pixel is converted and tested in one go, without the HSV image
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        CV_Assert(src.depth() == CV_8U && (src.channels() == 3 || src.channels() == 4));
+        uchar lo[3], hi[3];
+        hsv_bound(lower, lo);
+        hsv_bound(upper, hi);
+        dst.create(src.size(), CV_8UC1);
+        upyhal_inRangeHSV8u_init();
+        parallel_pointwise(src, dst, [&](Mat s, Mat d) {
+            upyhal_inRangeHSV8u(s.data, s.step, d.data, d.step, s.cols, s.rows, s.channels(), lo, hi);
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_core_minMaxLoc(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_mask };
     static const mp_arg_t allowed_args[] = {
@@ -155,6 +382,7 @@ mp_obj_t cv2_core_minMaxLoc(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
     Point minLoc, maxLoc;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         minMaxLoc(src, &minVal, &maxVal, &minLoc, &maxLoc, mask);
     } catch(Exception& e) {
@@ -162,6 +390,7 @@ mp_obj_t cv2_core_minMaxLoc(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t min_loc_tuple[2] = {
         mp_obj_new_float(minLoc.x),
         mp_obj_new_float(minLoc.y)
@@ -178,3 +407,40 @@ mp_obj_t cv2_core_minMaxLoc(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
     };
     return mp_obj_new_tuple(4, result_tuple);
 }
+
+mp_obj_t cv2_core_getNumThreads(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    // Call the corresponding OpenCV function
+    int retval = getNumThreads();
+
+    // Return the result
+    return mp_obj_new_int(retval);
+}
+
+mp_obj_t cv2_core_setNumThreads(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_nthreads };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_nthreads, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    int nthreads = args[ARG_nthreads].u_int;
+
+    // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        setNumThreads(nthreads);
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return mp_const_none;
+}
@@ -15,20 +15,32 @@
 
 // Function declarations
 extern mp_obj_t cv2_core_convertScaleAbs(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_core_frombuffer(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_core_getNumThreads(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 extern mp_obj_t cv2_core_inRange(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_core_inRangeHSV(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 extern mp_obj_t cv2_core_minMaxLoc(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_core_setNumThreads(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
 
 // Python references to the functions
 static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_core_convertScaleAbs_obj, 1, cv2_core_convertScaleAbs);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_core_frombuffer_obj, 3, cv2_core_frombuffer);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_core_getNumThreads_obj, 0, cv2_core_getNumThreads);
 static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_core_inRange_obj, 3, cv2_core_inRange);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_core_inRangeHSV_obj, 3, cv2_core_inRangeHSV);
 static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_core_minMaxLoc_obj, 1, cv2_core_minMaxLoc);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_core_setNumThreads_obj, 1, cv2_core_setNumThreads);
 
 // Global definitions for functions and constants
 #define OPENCV_CORE_GLOBALS \
     /* Functions */ \
     { MP_ROM_QSTR(MP_QSTR_convertScaleAbs), MP_ROM_PTR(&cv2_core_convertScaleAbs_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_frombuffer), MP_ROM_PTR(&cv2_core_frombuffer_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_getNumThreads), MP_ROM_PTR(&cv2_core_getNumThreads_obj) }, \
     { MP_ROM_QSTR(MP_QSTR_inRange), MP_ROM_PTR(&cv2_core_inRange_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_inRangeHSV), MP_ROM_PTR(&cv2_core_inRangeHSV_obj) }, \
     { MP_ROM_QSTR(MP_QSTR_minMaxLoc), MP_ROM_PTR(&cv2_core_minMaxLoc_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_setNumThreads), MP_ROM_PTR(&cv2_core_setNumThreads_obj) }, \
     \
     /* OpenCV data types, from opencv2/core/hal/interface.h */ \
     /* Other types are currently not supported by ulab */ \
@@ -36,7 +48,28 @@ static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_core_minMaxLoc_obj, 1, cv2_core_minMaxLoc)
     { MP_ROM_QSTR(MP_QSTR_CV_8S), MP_ROM_INT(1) }, \
     { MP_ROM_QSTR(MP_QSTR_CV_16U), MP_ROM_INT(2) }, \
     { MP_ROM_QSTR(MP_QSTR_CV_16S), MP_ROM_INT(3) }, \
-    { MP_ROM_QSTR(MP_QSTR_CV_32F), MP_ROM_INT(4) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_32F), MP_ROM_INT(5) }, \
+    /* Multi-channel types, from CV_MAKETYPE(depth, channels) */ \
+    { MP_ROM_QSTR(MP_QSTR_CV_8UC1), MP_ROM_INT(0) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_8UC2), MP_ROM_INT(8) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_8UC3), MP_ROM_INT(16) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_8UC4), MP_ROM_INT(24) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_8SC1), MP_ROM_INT(1) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_8SC2), MP_ROM_INT(9) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_8SC3), MP_ROM_INT(17) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_8SC4), MP_ROM_INT(25) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_16UC1), MP_ROM_INT(2) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_16UC2), MP_ROM_INT(10) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_16UC3), MP_ROM_INT(18) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_16UC4), MP_ROM_INT(26) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_16SC1), MP_ROM_INT(3) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_16SC2), MP_ROM_INT(11) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_16SC3), MP_ROM_INT(19) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_16SC4), MP_ROM_INT(27) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_32FC1), MP_ROM_INT(5) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_32FC2), MP_ROM_INT(13) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_32FC3), MP_ROM_INT(21) }, \
+    { MP_ROM_QSTR(MP_QSTR_CV_32FC4), MP_ROM_INT(29) }, \
     \
     /* Border types, from opencv2/core/base.hpp */ \
     { MP_ROM_QSTR(MP_QSTR_BORDER_CONSTANT), MP_ROM_INT(0) }, \
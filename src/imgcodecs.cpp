@@ -15,6 +15,7 @@
 #include "opencv2/imgcodecs.hpp"
 #include "convert.h"
 #include "numpy.h"
+#include "profile_scope.h"
 
 // C headers
 extern "C" {
@@ -38,6 +39,8 @@ using namespace cv;
     }
 
 mp_obj_t cv2_imgcodecs_imread(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_filename, ARG_flags };
     static const mp_arg_t allowed_args[] = {
@@ -78,6 +81,7 @@ mp_obj_t cv2_imgcodecs_imread(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     // Decode the image from the buffer
     Mat img;
     img.allocator = &GetNumpyAllocator();
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         img = imdecode(buf, flags);
     } catch(Exception& e) {
@@ -85,10 +89,13 @@ mp_obj_t cv2_imgcodecs_imread(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgcodecs_imwrite(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_filename, ARG_img, ARG_params };
     static const mp_arg_t allowed_args[] = {
@@ -135,6 +142,7 @@ mp_obj_t cv2_imgcodecs_imwrite(size_t n_args, const mp_obj_t *pos_args, mp_map_t
 
     // Encode the image from the buffer
     bool retval;
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = imencode(filename_str, img, buf, params_vec);
     } catch(Exception& e) {
@@ -142,6 +150,7 @@ mp_obj_t cv2_imgcodecs_imwrite(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     }
 
     // Convert the vector of uint8_t to a bytes object
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t buf_obj = mp_obj_new_bytes((const byte *)buf.data(), buf.size());
 
     // Call MicroPython's `open()` function to write the image file
@@ -13,8 +13,12 @@
 // C++ headers
 #include "opencv2/core.hpp"
 #include "opencv2/imgproc.hpp"
+#include "components.h"
 #include "convert.h"
 #include "numpy.h"
+#include "ops.h"
+#include "parallel.h"
+#include "profile_scope.h"
 
 // C headers
 extern "C" {
@@ -24,7 +28,20 @@ extern "C" {
 
 using namespace cv;
 
+// Returns true for color conversion codes that demosaic Bayer images. These
+// interpolate between rows, so they can't be split into bands of rows
+bool is_bayer_code(int code)
+{
+    return (code >= COLOR_BayerBG2BGR && code <= COLOR_BayerGR2BGR)
+        || (code >= COLOR_BayerBG2BGR_VNG && code <= COLOR_BayerGR2BGR_VNG)
+        || (code >= COLOR_BayerBG2GRAY && code <= COLOR_BayerGR2GRAY)
+        || (code >= COLOR_BayerBG2BGR_EA && code <= COLOR_BayerGR2BGR_EA)
+        || (code >= COLOR_BayerBG2BGRA && code <= COLOR_BayerGR2BGRA);
+}
+
 mp_obj_t cv2_imgproc_adaptiveThreshold(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_maxValue, ARG_adaptiveMethod, ARG_thresholdType, ARG_blockSize, ARG_C, ARG_dst };
     static const mp_arg_t allowed_args[] = {
@@ -51,6 +68,7 @@ mp_obj_t cv2_imgproc_adaptiveThreshold(size_t n_args, const mp_obj_t *pos_args,
     Mat dst = mp_obj_to_mat(args[ARG_dst].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         adaptiveThreshold(src, dst, maxValue, adaptiveMethod, thresholdType, blockSize, C);
     } catch(Exception& e) {
@@ -58,10 +76,13 @@ mp_obj_t cv2_imgproc_adaptiveThreshold(size_t n_args, const mp_obj_t *pos_args,
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_approxPolyDP(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_curve, ARG_epsilon, ARG_closed, ARG_approxCurve };
     static const mp_arg_t allowed_args[] = {
@@ -76,12 +97,13 @@ mp_obj_t cv2_imgproc_approxPolyDP(size_t n_args, const mp_obj_t *pos_args, mp_ma
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat curve = mp_obj_to_mat(args[ARG_curve].u_obj);
+    Mat curve = mp_obj_to_points(args[ARG_curve].u_obj);
     double epsilon = mp_obj_get_float(args[ARG_epsilon].u_obj);
     bool closed = args[ARG_closed].u_bool;
     Mat approxCurve = mp_obj_to_mat(args[ARG_approxCurve].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         approxPolyDP(curve, approxCurve, epsilon, closed);
     } catch(Exception& e) {
@@ -89,10 +111,13 @@ mp_obj_t cv2_imgproc_approxPolyDP(size_t n_args, const mp_obj_t *pos_args, mp_ma
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(approxCurve);
 }
 
 mp_obj_t cv2_imgproc_approxPolyN(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_curve, ARG_nsides, ARG_approxCurve, ARG_epsilon_percentage, ARG_ensure_convex };
     static const mp_arg_t allowed_args[] = {
@@ -108,13 +133,14 @@ mp_obj_t cv2_imgproc_approxPolyN(size_t n_args, const mp_obj_t *pos_args, mp_map
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat curve = mp_obj_to_mat(args[ARG_curve].u_obj);
+    Mat curve = mp_obj_to_points(args[ARG_curve].u_obj);
     int nsides = args[ARG_nsides].u_int;
     Mat approxCurve = mp_obj_to_mat(args[ARG_approxCurve].u_obj);
     mp_float_t epsilon_percentage = args[ARG_epsilon_percentage].u_obj == mp_const_none ? -1.0 : mp_obj_get_float(args[ARG_epsilon_percentage].u_obj);
     bool ensure_convex = args[ARG_ensure_convex].u_bool;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         approxPolyN(curve, approxCurve, nsides, epsilon_percentage, ensure_convex);
     } catch(Exception& e) {
@@ -122,10 +148,13 @@ mp_obj_t cv2_imgproc_approxPolyN(size_t n_args, const mp_obj_t *pos_args, mp_map
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(approxCurve);
 }
 
 mp_obj_t cv2_imgproc_arcLength(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_curve, ARG_closed };
     static const mp_arg_t allowed_args[] = {
@@ -138,12 +167,13 @@ mp_obj_t cv2_imgproc_arcLength(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat curve = mp_obj_to_mat(args[ARG_curve].u_obj);
+    Mat curve = mp_obj_to_points(args[ARG_curve].u_obj);
     bool closed = args[ARG_closed].u_bool;
 
     mp_float_t retval;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = arcLength(curve, closed);
     } catch(Exception& e) {
@@ -151,10 +181,13 @@ mp_obj_t cv2_imgproc_arcLength(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mp_obj_new_float(retval);
 }
 
 mp_obj_t cv2_imgproc_arrowedLine(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_pt1, ARG_pt2, ARG_color, ARG_thickness, ARG_line_type, ARG_shift, ARG_tipLength };
     static const mp_arg_t allowed_args[] = {
@@ -187,6 +220,7 @@ mp_obj_t cv2_imgproc_arrowedLine(size_t n_args, const mp_obj_t *pos_args, mp_map
         tipLength = mp_obj_get_float(args[ARG_tipLength].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         arrowedLine(img, pt1, pt2, color, thickness, line_type, shift, tipLength);
     } catch(Exception& e) {
@@ -194,10 +228,13 @@ mp_obj_t cv2_imgproc_arrowedLine(size_t n_args, const mp_obj_t *pos_args, mp_map
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgproc_bilateralFilter(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_d, ARG_sigmaColor, ARG_sigmaSpace, ARG_dst, ARG_borderType };
     static const mp_arg_t allowed_args[] = {
@@ -222,6 +259,7 @@ mp_obj_t cv2_imgproc_bilateralFilter(size_t n_args, const mp_obj_t *pos_args, mp
     int borderType = args[ARG_borderType].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         bilateralFilter(src, dst, d, sigmaColor, sigmaSpace, borderType);
     } catch(Exception& e) {
@@ -229,10 +267,21 @@ mp_obj_t cv2_imgproc_bilateralFilter(size_t n_args, const mp_obj_t *pos_args, mp
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
+void op_blur(const Mat& src, Mat& dst, Size ksize, Point anchor, int borderType)
+{
+    dst.create(src.size(), src.type());
+    parallel_filter(src, dst, borderType, filter_halo(ksize.height, anchor.y), [&](Mat s, Mat d) {
+        blur(s, d, ksize, anchor, borderType);
+    });
+}
+
 mp_obj_t cv2_imgproc_blur(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_ksize, ARG_dst, ARG_anchor, ARG_borderType };
     static const mp_arg_t allowed_args[] = {
@@ -255,17 +304,21 @@ mp_obj_t cv2_imgproc_blur(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
     int borderType = args[ARG_borderType].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        blur(src, dst, ksize, anchor, borderType);
+        op_blur(src, dst, ksize, anchor, borderType);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_boundingRect(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_array };
     static const mp_arg_t allowed_args[] = {
@@ -277,11 +330,18 @@ mp_obj_t cv2_imgproc_boundingRect(size_t n_args, const mp_obj_t *pos_args, mp_ma
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
+    // 8-bit arrays are images, anything else is a point set that must be float
     Mat array = mp_obj_to_mat(args[ARG_array].u_obj);
+    if(array.depth() != CV_8U && array.depth() != CV_32F) {
+        Mat array_f32;
+        array.convertTo(array_f32, CV_32F);
+        array = array_f32;
+    }
 
     Rect retval;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = boundingRect(array);
     } catch(Exception& e) {
@@ -289,6 +349,7 @@ mp_obj_t cv2_imgproc_boundingRect(size_t n_args, const mp_obj_t *pos_args, mp_ma
     }
 
     // Return the result as a tuple
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t retval_tuple[4];
     retval_tuple[0] = mp_obj_new_int(retval.x);
     retval_tuple[1] = mp_obj_new_int(retval.y);
@@ -299,6 +360,8 @@ mp_obj_t cv2_imgproc_boundingRect(size_t n_args, const mp_obj_t *pos_args, mp_ma
 }
 
 mp_obj_t cv2_imgproc_boxFilter(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_ddepth, ARG_ksize, ARG_dst, ARG_anchor, ARG_normalize, ARG_borderType };
     static const mp_arg_t allowed_args[] = {
@@ -325,17 +388,24 @@ mp_obj_t cv2_imgproc_boxFilter(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     int borderType = args[ARG_borderType].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        boxFilter(src, dst, ddepth, ksize, anchor, normalize, borderType);
+        dst.create(src.size(), CV_MAKETYPE(ddepth < 0 ? src.depth() : ddepth, src.channels()));
+        parallel_filter(src, dst, borderType, filter_halo(ksize.height, anchor.y), [&](Mat s, Mat d) {
+            boxFilter(s, d, ddepth, ksize, anchor, normalize, borderType);
+        });
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_boxPoints(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_box, ARG_points };
     static const mp_arg_t allowed_args[] = {
@@ -356,6 +426,7 @@ mp_obj_t cv2_imgproc_boxPoints(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     Mat points = mp_obj_to_mat(args[ARG_points].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         boxPoints(box, points);
     } catch(Exception& e) {
@@ -363,10 +434,13 @@ mp_obj_t cv2_imgproc_boxPoints(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(points);
 }
 
 mp_obj_t cv2_imgproc_Canny(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_threshold1, ARG_threshold2, ARG_edges, ARG_apertureSize, ARG_L2gradient };
     static const mp_arg_t allowed_args[] = {
@@ -390,18 +464,30 @@ mp_obj_t cv2_imgproc_Canny(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw
     int apertureSize = args[ARG_apertureSize].u_int;
     bool L2gradient = args[ARG_L2gradient].u_bool;
 
+    // Canny() merges the results of its parallel stripes under a cv::Mutex,
+    // which does nothing because OpenCV is built without thread support, so
+    // it must only run on one core
+    int numThreads = getNumThreads();
+    setNumThreads(1);
+
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         Canny(image, edges, threshold1, threshold2, apertureSize, L2gradient);
     } catch(Exception& e) {
+        setNumThreads(numThreads);
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
+    setNumThreads(numThreads);
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(edges);
 }
 
 mp_obj_t cv2_imgproc_circle(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_center, ARG_radius, ARG_color, ARG_thickness, ARG_lineType, ARG_shift };
     static const mp_arg_t allowed_args[] = {
@@ -428,6 +514,7 @@ mp_obj_t cv2_imgproc_circle(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
     int shift = args[ARG_shift].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         circle(img, center, radius, color, thickness, lineType, shift);
     } catch(Exception& e) {
@@ -435,10 +522,13 @@ mp_obj_t cv2_imgproc_circle(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgproc_connectedComponents(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_labels, ARG_connectivity, ARG_ltype };
     static const mp_arg_t allowed_args[] = {
@@ -462,6 +552,7 @@ mp_obj_t cv2_imgproc_connectedComponents(size_t n_args, const mp_obj_t *pos_args
     int retval = 0;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = connectedComponents(image, labels, connectivity, ltype);
     } catch(Exception& e) {
@@ -469,13 +560,74 @@ mp_obj_t cv2_imgproc_connectedComponents(size_t n_args, const mp_obj_t *pos_args
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t result[2];
     result[0] = mp_obj_new_int(retval);
     result[1] = mat_to_mp_obj(labels);
     return mp_obj_new_tuple(2, result);
 }
 
+mp_obj_t cv2_imgproc_connectedComponentsStats(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_image, ARG_connectivity, ARG_min_area };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_image, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_connectivity, MP_ARG_INT, { .u_int = 8 } },
+        { MP_QSTR_min_area, MP_ARG_INT, { .u_int = 0 } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat image = mp_obj_to_mat(args[ARG_image].u_obj);
+    int connectivity = args[ARG_connectivity].u_int;
+    int min_area = args[ARG_min_area].u_int;
+
+    // Outputs, with one row per component
+    Mat stats;
+    Mat centroids;
+    stats.allocator = &GetNumpyAllocator();
+    centroids.allocator = &GetNumpyAllocator();
+
+    // Return value
+    int retval = 0;
+
+    // Compute the statistics one row at a time, without a label image
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        CV_Assert(image.type() == CV_8UC1);
+        ComponentLabeler labeler(image.cols, connectivity, std::max(min_area, 1));
+        std::vector<int> runs;
+        runs.reserve(image.cols + 1);
+        for(int y = 0; y < image.rows; y++) {
+            runs.clear();
+            row_runs(image.ptr<uchar>(y), image.cols, runs);
+            labeler.addRow(y, runs.data(), (int) runs.size() / 2);
+        }
+        labeler.finish();
+
+        retval = (int) labeler.components.size();
+        components_to_mats(labeler.components, stats, centroids);
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    mp_obj_t result[3];
+    result[0] = mp_obj_new_int(retval);
+    result[1] = mat_to_mp_obj(stats);
+    result[2] = mat_to_mp_obj(centroids);
+    return mp_obj_new_tuple(3, result);
+}
+
 mp_obj_t cv2_imgproc_connectedComponentsWithStats(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_labels, ARG_stats, ARG_centroids, ARG_connectivity, ARG_ltype };
     static const mp_arg_t allowed_args[] = {
@@ -491,34 +643,45 @@ mp_obj_t cv2_imgproc_connectedComponentsWithStats(size_t n_args, const mp_obj_t
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
-    // Convert arguments to required types
+    // Convert arguments to required types. OpenCV writes the labels directly
+    // into the labels array if it has the right shape and type
     Mat image = mp_obj_to_mat(args[ARG_image].u_obj);
-    Mat labels32S; // TODO: Allow user input
-    Mat stats32S; // TODO: Allow user input
-    Mat centroids64F; // TODO: Allow user input
+    Mat labels = mp_obj_to_mat(args[ARG_labels].u_obj);
+    Mat stats = mp_obj_to_mat(args[ARG_stats].u_obj);
+    Mat centroids = mp_obj_to_mat(args[ARG_centroids].u_obj);
     int connectivity = args[ARG_connectivity].u_int;
     int ltype = args[ARG_ltype].u_int;
 
+    // OpenCV always outputs CV_32S stats and CV_64F centroids, which ulab
+    // doesn't support. These only have one row per label, so they're computed
+    // separately and converted into the stats and centroids arrays
+    Mat stats32S;
+    Mat centroids64F;
+
     // Return value
     int retval = 0;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        retval = connectedComponentsWithStats(image, labels32S, stats32S, centroids64F, connectivity, ltype);
+        // ulab can't hold CV_32S labels either, so if they're asked for
+        // explicitly, they're computed into a separate Mat and converted into
+        // the labels array as float
+        if(ltype == CV_32S) {
+            Mat labels32S;
+            retval = connectedComponentsWithStats(image, labels32S, stats32S, centroids64F, connectivity, ltype);
+            labels32S.convertTo(labels, CV_32F);
+        } else {
+            retval = connectedComponentsWithStats(image, labels, stats32S, centroids64F, connectivity, ltype);
+        }
+        stats32S.convertTo(stats, CV_32F);
+        centroids64F.convertTo(centroids, CV_32F);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
-    // Convert output matrices to float
-    Mat labels, stats, centroids;
-    labels.allocator = &GetNumpyAllocator();
-    stats.allocator = &GetNumpyAllocator();
-    centroids.allocator = &GetNumpyAllocator();
-    labels32S.convertTo(labels, CV_32F);
-    stats32S.convertTo(stats, CV_32F);
-    centroids64F.convertTo(centroids, CV_32F);
-
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t result[4];
     result[0] = mp_obj_new_int(retval);
     result[1] = mat_to_mp_obj(labels);
@@ -528,6 +691,8 @@ mp_obj_t cv2_imgproc_connectedComponentsWithStats(size_t n_args, const mp_obj_t
 }
 
 mp_obj_t cv2_imgproc_contourArea(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_contour, ARG_oriented };
     static const mp_arg_t allowed_args[] = {
@@ -540,12 +705,13 @@ mp_obj_t cv2_imgproc_contourArea(size_t n_args, const mp_obj_t *pos_args, mp_map
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat contour = mp_obj_to_mat(args[ARG_contour].u_obj);
+    Mat contour = mp_obj_to_points(args[ARG_contour].u_obj);
     bool oriented = args[ARG_oriented].u_bool;
 
     mp_float_t retval;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = contourArea(contour, oriented);
     } catch(Exception& e) {
@@ -553,10 +719,13 @@ mp_obj_t cv2_imgproc_contourArea(size_t n_args, const mp_obj_t *pos_args, mp_map
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mp_obj_new_float(retval);
 }
 
 mp_obj_t cv2_imgproc_convexHull(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_points, ARG_hull, ARG_clockwise, ARG_returnPoints };
     static const mp_arg_t allowed_args[] = {
@@ -571,12 +740,13 @@ mp_obj_t cv2_imgproc_convexHull(size_t n_args, const mp_obj_t *pos_args, mp_map_
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat points = mp_obj_to_mat(args[ARG_points].u_obj);
+    Mat points = mp_obj_to_points(args[ARG_points].u_obj);
     Mat hull; // TODO: Allow user input
     bool clockwise = args[ARG_clockwise].u_bool;
     bool returnPoints = args[ARG_returnPoints].u_bool;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         convexHull(points, hull, clockwise, returnPoints);
     } catch(Exception& e) {
@@ -584,6 +754,7 @@ mp_obj_t cv2_imgproc_convexHull(size_t n_args, const mp_obj_t *pos_args, mp_map_
     }
 
     // If hull is 32S, convert it to float
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     if (hull.type() == CV_32S) {
         Mat hullFloat;
         hull.convertTo(hullFloat, CV_32F);
@@ -595,6 +766,8 @@ mp_obj_t cv2_imgproc_convexHull(size_t n_args, const mp_obj_t *pos_args, mp_map_
 }
 
 mp_obj_t cv2_imgproc_convexityDefects(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_contour, ARG_convexhull, ARG_convexityDefects };
     static const mp_arg_t allowed_args[] = {
@@ -621,6 +794,7 @@ mp_obj_t cv2_imgproc_convexityDefects(size_t n_args, const mp_obj_t *pos_args, m
     convexhull.convertTo(convexhull32S, CV_32S);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         cv::convexityDefects(contour32S, convexhull32S, convexityDefects32S);
     } catch(Exception& e) {
@@ -628,6 +802,7 @@ mp_obj_t cv2_imgproc_convexityDefects(size_t n_args, const mp_obj_t *pos_args, m
     }
 
     // Convert the convexityDefects32S to float
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     Mat convexityDefects;
     convexityDefects.allocator = &GetNumpyAllocator();
     convexityDefects32S.convertTo(convexityDefects, CV_32F);
@@ -636,7 +811,32 @@ mp_obj_t cv2_imgproc_convexityDefects(size_t n_args, const mp_obj_t *pos_args, m
     return mat_to_mp_obj(convexityDefects);
 }
 
+void op_cvtColor(const Mat& src, Mat& dst, int code)
+{
+    // Convert the first row on its own to find the type of dst. That also
+    // rules out conversions that change the number of rows (eg. YUV 4:2:0),
+    // which throw an exception or return a different size
+    Mat row;
+    if(getNumThreads() > 1 && src.rows >= 2 * CV2_PARALLEL_MIN_BAND_ROWS && !is_bayer_code(code)) {
+        try {
+            cvtColor(src.rowRange(0, 1), row, code);
+        } catch(Exception&) {
+            row.release();
+        }
+    }
+    if(row.rows == 1 && row.cols == src.cols) {
+        dst.create(src.size(), row.type());
+        parallel_pointwise(src, dst, [&](Mat s, Mat d) {
+            cvtColor(s, d, code);
+        });
+    } else {
+        cvtColor(src, dst, code);
+    }
+}
+
 mp_obj_t cv2_imgproc_cvtColor(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_code, ARG_dst };
     static const mp_arg_t allowed_args[] = {
@@ -655,17 +855,136 @@ mp_obj_t cv2_imgproc_cvtColor(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     Mat dst = mp_obj_to_mat(args[ARG_dst].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        cvtColor(src, dst, code);
+        op_cvtColor(src, dst, code);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
+void op_dilate(const Mat& src, Mat& dst, const Mat& kernel, Point anchor, int iterations, int borderType, const Scalar& borderValue)
+{
+    // Each iteration needs the result of the previous one from the other
+    // bands, so only a single iteration can be split into bands
+    if(iterations == 1) {
+        dst.create(src.size(), src.type());
+        parallel_filter(src, dst, borderType, filter_halo(kernel.empty() ? 3 : kernel.rows, anchor.y), [&](Mat s, Mat d) {
+            dilate(s, d, kernel, anchor, iterations, borderType, borderValue);
+        });
+    } else {
+        dilate(src, dst, kernel, anchor, iterations, borderType, borderValue);
+    }
+}
+
+mp_obj_t cv2_imgproc_detectColorBlobs(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_frame, ARG_lower, ARG_upper, ARG_min_area, ARG_max_blobs, ARG_code, ARG_connectivity };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_frame, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_lower, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_upper, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_min_area, MP_ARG_INT, { .u_int = 0 } },
+        { MP_QSTR_max_blobs, MP_ARG_INT, { .u_int = 0 } },
+        { MP_QSTR_code, MP_ARG_INT, { .u_int = COLOR_BGR2HSV } },
+        { MP_QSTR_connectivity, MP_ARG_INT, { .u_int = 8 } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat frame = mp_obj_to_mat(args[ARG_frame].u_obj);
+    Mat lower = mp_obj_to_mat(args[ARG_lower].u_obj);
+    Mat upper = mp_obj_to_mat(args[ARG_upper].u_obj);
+    int min_area = args[ARG_min_area].u_int;
+    int max_blobs = args[ARG_max_blobs].u_int;
+    int code = args[ARG_code].u_int;
+    int connectivity = args[ARG_connectivity].u_int;
+
+    // One row per blob, see below
+    Mat blobs;
+    blobs.allocator = &GetNumpyAllocator();
+
+    // The frame is processed in chunks of rows. Each chunk is converted and
+    // classified on both cores into a mask of just those rows, and then its
+    // runs are merged into blobs, so no full-size image is ever allocated
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        // Bayer conversions need the neighboring rows, and some conversions
+        // change the size of the image, so check the first row first. Its
+        // type is what the bounds get converted for, once for every row
+        CV_Assert(!is_bayer_code(code));
+        int row_type = frame.type();
+        if(code >= 0 && frame.rows > 0) {
+            Mat probe;
+            cvtColor(frame.row(0), probe, code);
+            CV_Assert(probe.rows == 1 && probe.cols == frame.cols);
+            row_type = probe.type();
+        }
+        InRangeBounds bounds = op_inRange_bounds(Size(frame.cols, 1), row_type, lower, upper);
+
+        int chunk_rows = std::min(2 * CV2_PARALLEL_MIN_BAND_ROWS, std::max(frame.rows, 1));
+        Mat mask(chunk_rows, frame.cols, CV_8UC1);
+        ComponentLabeler labeler(frame.cols, connectivity, std::max(min_area, 1));
+        std::vector<int> runs;
+        runs.reserve(frame.cols + 1);
+        for(int y0 = 0; y0 < frame.rows; y0 += chunk_rows) {
+            int n = std::min(chunk_rows, frame.rows - y0);
+            parallel_rows(n, [&](const Range& range) {
+                Mat color;
+                for(int i = range.start; i < range.end; i++) {
+                    Mat row = frame.row(y0 + i);
+                    if(code >= 0) {
+                        cvtColor(row, color, code);
+                        row = color;
+                    }
+                    Mat mask_row = mask.row(i);
+                    op_inRange_row(bounds, row, 0, mask_row);
+                }
+            });
+            for(int i = 0; i < n; i++) {
+                runs.clear();
+                row_runs(mask.ptr<uchar>(i), frame.cols, runs);
+                labeler.addRow(y0 + i, runs.data(), (int) runs.size() / 2);
+            }
+        }
+        labeler.finish();
+
+        // Keep the largest blobs
+        std::vector<ComponentStats>& found = labeler.components;
+        std::stable_sort(found.begin(), found.end(), [](const ComponentStats& a, const ComponentStats& b) {
+            return a.area > b.area;
+        });
+        if(max_blobs > 0 && (int) found.size() > max_blobs)
+            found.resize(max_blobs);
+
+        // Each row is the stats of connectedComponentsWithStats(), followed
+        // by the centroid
+        if(!found.empty()) {
+            Mat stats, centroids;
+            components_to_mats(found, stats, centroids);
+            hconcat(stats, centroids, blobs);
+        }
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return mat_to_mp_obj(blobs);
+}
+
 mp_obj_t cv2_imgproc_dilate(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_kernel, ARG_dst, ARG_anchor, ARG_iterations, ARG_borderType, ARG_borderValue };
     static const mp_arg_t allowed_args[] = {
@@ -700,17 +1019,21 @@ mp_obj_t cv2_imgproc_dilate(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
         borderValue = mp_obj_to_scalar(args[ARG_borderValue].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        dilate(src, dst, kernel, anchor, iterations, borderType, borderValue);
+        op_dilate(src, dst, kernel, anchor, iterations, borderType, borderValue);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_drawContours(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_contours, ARG_contourIdx, ARG_color, ARG_thickness, ARG_lineType, ARG_hierarchy, ARG_maxLevel, ARG_offset };
     static const mp_arg_t allowed_args[] = {
@@ -731,7 +1054,7 @@ mp_obj_t cv2_imgproc_drawContours(size_t n_args, const mp_obj_t *pos_args, mp_ma
 
     // Convert arguments to required types
     Mat image = mp_obj_to_mat(args[ARG_image].u_obj);
-    std::vector<std::vector<Point>> contours = mp_obj_to_contours(args[ARG_contours].u_obj);
+    std::vector<Mat> contours = mp_obj_to_contours(args[ARG_contours].u_obj);
     int contourIdx = args[ARG_contourIdx].u_int;
     Scalar color = mp_obj_to_scalar(args[ARG_color].u_obj);
     int thickness = args[ARG_thickness].u_int;
@@ -741,6 +1064,7 @@ mp_obj_t cv2_imgproc_drawContours(size_t n_args, const mp_obj_t *pos_args, mp_ma
     Point offset = args[ARG_offset].u_obj != mp_const_none ? mp_obj_to_point(args[ARG_offset].u_obj) : Point();
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         drawContours(image, contours, contourIdx, color, thickness, lineType, hierarchy, maxLevel, offset);
     } catch(Exception& e) {
@@ -748,10 +1072,13 @@ mp_obj_t cv2_imgproc_drawContours(size_t n_args, const mp_obj_t *pos_args, mp_ma
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(image);
 }
 
 mp_obj_t cv2_imgproc_drawMarker(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_position, ARG_color, ARG_markerType, ARG_markerSize, ARG_thickness, ARG_line_type };
     static const mp_arg_t allowed_args[] = {
@@ -778,6 +1105,7 @@ mp_obj_t cv2_imgproc_drawMarker(size_t n_args, const mp_obj_t *pos_args, mp_map_
     int line_type = args[ARG_line_type].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         drawMarker(img, position, color, markerType, markerSize, thickness, line_type);
     } catch(Exception& e) {
@@ -785,10 +1113,13 @@ mp_obj_t cv2_imgproc_drawMarker(size_t n_args, const mp_obj_t *pos_args, mp_map_
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgproc_ellipse(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_center, ARG_axes, ARG_angle, ARG_startAngle, ARG_endAngle, ARG_color, ARG_thickness, ARG_lineType, ARG_shift };
     static const mp_arg_t allowed_args[] = {
@@ -821,6 +1152,7 @@ mp_obj_t cv2_imgproc_ellipse(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     int shift = args[ARG_shift].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         ellipse(img, center, axes, angle, startAngle, endAngle, color, thickness, lineType, shift);
     } catch(Exception& e) {
@@ -828,10 +1160,27 @@ mp_obj_t cv2_imgproc_ellipse(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
+void op_erode(const Mat& src, Mat& dst, const Mat& kernel, Point anchor, int iterations, int borderType, const Scalar& borderValue)
+{
+    // Each iteration needs the result of the previous one from the other
+    // bands, so only a single iteration can be split into bands
+    if(iterations == 1) {
+        dst.create(src.size(), src.type());
+        parallel_filter(src, dst, borderType, filter_halo(kernel.empty() ? 3 : kernel.rows, anchor.y), [&](Mat s, Mat d) {
+            erode(s, d, kernel, anchor, iterations, borderType, borderValue);
+        });
+    } else {
+        erode(src, dst, kernel, anchor, iterations, borderType, borderValue);
+    }
+}
+
 mp_obj_t cv2_imgproc_erode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_kernel, ARG_dst, ARG_anchor, ARG_iterations, ARG_borderType, ARG_borderValue };
     static const mp_arg_t allowed_args[] = {
@@ -866,17 +1215,21 @@ mp_obj_t cv2_imgproc_erode(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw
         borderValue = mp_obj_to_scalar(args[ARG_borderValue].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        erode(src, dst, kernel, anchor, iterations, borderType, borderValue);
+        op_erode(src, dst, kernel, anchor, iterations, borderType, borderValue);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_fillConvexPoly(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_points, ARG_color, ARG_lineType, ARG_shift };
     static const mp_arg_t allowed_args[] = {
@@ -904,6 +1257,7 @@ mp_obj_t cv2_imgproc_fillConvexPoly(size_t n_args, const mp_obj_t *pos_args, mp_
     points.convertTo(points_32S, CV_32S);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         fillConvexPoly(img, points_32S, color, lineType, shift);
     } catch(Exception& e) {
@@ -911,10 +1265,13 @@ mp_obj_t cv2_imgproc_fillConvexPoly(size_t n_args, const mp_obj_t *pos_args, mp_
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgproc_fillPoly(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_pts, ARG_color, ARG_lineType, ARG_shift, ARG_offset };
     static const mp_arg_t allowed_args[] = {
@@ -932,7 +1289,7 @@ mp_obj_t cv2_imgproc_fillPoly(size_t n_args, const mp_obj_t *pos_args, mp_map_t
 
     // Convert arguments to required types
     Mat img = mp_obj_to_mat(args[ARG_img].u_obj);
-    Mat pts = mp_obj_to_mat(args[ARG_pts].u_obj);
+    std::vector<Mat> pts = mp_obj_to_contours(args[ARG_pts].u_obj);
     Scalar color = mp_obj_to_scalar(args[ARG_color].u_obj);
     int lineType = args[ARG_lineType].u_int;
     int shift = args[ARG_shift].u_int;
@@ -942,23 +1299,22 @@ mp_obj_t cv2_imgproc_fillPoly(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     else
         offset = mp_obj_to_point(args[ARG_offset].u_obj);
 
-    // points must be of type CV_32S
-    Mat pts_32S;
-    pts.allocator = &GetNumpyAllocator();
-    pts.convertTo(pts_32S, CV_32S);
-
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        fillPoly(img, pts_32S, color, lineType, shift, offset);
+        fillPoly(img, pts, color, lineType, shift, offset);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgproc_filter2D(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_ddepth, ARG_kernel, ARG_dst, ARG_anchor, ARG_delta, ARG_borderType };
     static const mp_arg_t allowed_args[] = {
@@ -989,19 +1345,26 @@ mp_obj_t cv2_imgproc_filter2D(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     int borderType = args[ARG_borderType].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        filter2D(src, dst, ddepth, kernel, anchor, delta, borderType);
+        dst.create(src.size(), CV_MAKETYPE(ddepth < 0 ? src.depth() : ddepth, src.channels()));
+        parallel_filter(src, dst, borderType, filter_halo(kernel.rows, anchor.y), [&](Mat s, Mat d) {
+            filter2D(s, d, ddepth, kernel, anchor, delta, borderType);
+        });
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_findContours(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
-    enum { ARG_image, ARG_mode, ARG_method, ARG_contours, ARG_hierarchy, ARG_offset };
+    enum { ARG_image, ARG_mode, ARG_method, ARG_contours, ARG_hierarchy, ARG_offset, ARG_packed };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_image, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
         { MP_QSTR_mode, MP_ARG_REQUIRED | MP_ARG_INT, { .u_int = 0 } },
@@ -1009,6 +1372,7 @@ mp_obj_t cv2_imgproc_findContours(size_t n_args, const mp_obj_t *pos_args, mp_ma
         { MP_QSTR_contours, MP_ARG_OBJ, { .u_obj = mp_const_none } },
         { MP_QSTR_hierarchy, MP_ARG_OBJ, { .u_obj = mp_const_none } },
         { MP_QSTR_offset, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+        { MP_QSTR_packed, MP_ARG_BOOL, { .u_bool = false } },
     };
 
     // Parse the arguments
@@ -1022,38 +1386,24 @@ mp_obj_t cv2_imgproc_findContours(size_t n_args, const mp_obj_t *pos_args, mp_ma
     std::vector<std::vector<Point>> contours; // TODO: Allow user input
     std::vector<Vec4i> hierarchy; // TODO: Allow user input
     Point offset = args[ARG_offset].u_obj == mp_const_none ? Point() : mp_obj_to_point(args[ARG_offset].u_obj);
+    bool packed = args[ARG_packed].u_bool;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         findContours(image, contours, hierarchy, mode, method, offset);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
-    // Convert contours to a tuple of ndarray objects
-    mp_obj_t contours_obj = mp_obj_new_tuple(contours.size(), NULL);
-    mp_obj_tuple_t *contours_tuple = (mp_obj_tuple_t*) MP_OBJ_TO_PTR(contours_obj);
-    
-    for(size_t i = 0; i < contours.size(); i++) {
-        Mat mat_contour(contours[i]);
-        Mat mat_f32;
-        mat_contour.convertTo(mat_f32, CV_32F);
-        contours_tuple->items[i] = mat_to_mp_obj(mat_f32);
-    }
-
-    // Convert hierarchy to a Mat object
-    Mat mat_hierarchy(hierarchy);
-
     // Return the result
-    mp_obj_t result_tuple[2];
-    result_tuple[0] = contours_tuple;
-    Mat mat_16s;
-    mat_hierarchy.convertTo(mat_16s, CV_16S);
-    result_tuple[1] = mat_to_mp_obj(mat_16s);
-    return mp_obj_new_tuple(2, result_tuple);
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return contours_to_mp_obj(contours, hierarchy, packed);
 }
 
 mp_obj_t cv2_imgproc_fitEllipse(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_points };
     static const mp_arg_t allowed_args[] = {
@@ -1065,11 +1415,12 @@ mp_obj_t cv2_imgproc_fitEllipse(size_t n_args, const mp_obj_t *pos_args, mp_map_
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat points = mp_obj_to_mat(args[ARG_points].u_obj);
+    Mat points = mp_obj_to_points(args[ARG_points].u_obj);
 
     RotatedRect ellipse;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         ellipse = fitEllipse(points);
     } catch(Exception& e) {
@@ -1077,6 +1428,7 @@ mp_obj_t cv2_imgproc_fitEllipse(size_t n_args, const mp_obj_t *pos_args, mp_map_
     }
 
     // Convert the result to a tuple
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t center[2];
     center[0] = mp_obj_new_float(ellipse.center.x);
     center[1] = mp_obj_new_float(ellipse.center.y);
@@ -1091,6 +1443,8 @@ mp_obj_t cv2_imgproc_fitEllipse(size_t n_args, const mp_obj_t *pos_args, mp_map_
 }
 
 mp_obj_t cv2_imgproc_fitLine(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_points, ARG_distType, ARG_param, ARG_reps, ARG_aeps, ARG_line };
     static const mp_arg_t allowed_args[] = {
@@ -1107,7 +1461,7 @@ mp_obj_t cv2_imgproc_fitLine(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat points = mp_obj_to_mat(args[ARG_points].u_obj);
+    Mat points = mp_obj_to_points(args[ARG_points].u_obj);
     int distType = args[ARG_distType].u_int;
     mp_float_t param = mp_obj_get_float(args[ARG_param].u_obj);
     mp_float_t reps = mp_obj_get_float(args[ARG_reps].u_obj);
@@ -1115,6 +1469,7 @@ mp_obj_t cv2_imgproc_fitLine(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     Mat line = mp_obj_to_mat(args[ARG_line].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         fitLine(points, line, distType, param, reps, aeps);
     } catch(Exception& e) {
@@ -1122,10 +1477,32 @@ mp_obj_t cv2_imgproc_fitLine(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(line);
 }
 
+// Rows of context GaussianBlur() needs on each side of a row. If ksize is 0,
+// OpenCV computes it from sigma like in createGaussianKernels(), which depends
+// on the depth of src, so this assumes the larger one
+int gaussian_halo(int ksize, double sigma)
+{
+    if(ksize <= 0)
+        ksize = cvRound(sigma * 4 * 2 + 1) | 1;
+    return filter_halo(ksize, -1);
+}
+
+void op_GaussianBlur(const Mat& src, Mat& dst, Size ksize, double sigmaX, double sigmaY, int borderType, AlgorithmHint hint)
+{
+    dst.create(src.size(), src.type());
+    int halo = gaussian_halo(ksize.height, sigmaY > 0 ? sigmaY : sigmaX);
+    parallel_filter(src, dst, borderType, halo, [&](Mat s, Mat d) {
+        GaussianBlur(s, d, ksize, sigmaX, sigmaY, borderType, hint);
+    });
+}
+
 mp_obj_t cv2_imgproc_GaussianBlur(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_ksize, ARG_sigmaX, ARG_dst, ARG_sigmaY, ARG_borderType, ARG_hint };
     static const mp_arg_t allowed_args[] = {
@@ -1152,17 +1529,21 @@ mp_obj_t cv2_imgproc_GaussianBlur(size_t n_args, const mp_obj_t *pos_args, mp_ma
     AlgorithmHint hint = (AlgorithmHint) args[ARG_hint].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        GaussianBlur(src, dst, ksize, sigmaX, sigmaY, borderType, hint);
+        op_GaussianBlur(src, dst, ksize, sigmaX, sigmaY, borderType, hint);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_getStructuringElement(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_shape, ARG_ksize, ARG_anchor };
     static const mp_arg_t allowed_args[] = {
@@ -1188,6 +1569,7 @@ mp_obj_t cv2_imgproc_getStructuringElement(size_t n_args, const mp_obj_t *pos_ar
     Mat kernel;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         kernel = getStructuringElement(shape, ksize, anchor);
     } catch(Exception& e) {
@@ -1195,10 +1577,13 @@ mp_obj_t cv2_imgproc_getStructuringElement(size_t n_args, const mp_obj_t *pos_ar
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(kernel);
 }
 
 mp_obj_t cv2_imgproc_HoughCircles(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_method, ARG_dp, ARG_minDist, ARG_circles, ARG_param1, ARG_param2, ARG_minRadius, ARG_maxRadius };
     static const mp_arg_t allowed_args[] = {
@@ -1236,18 +1621,30 @@ mp_obj_t cv2_imgproc_HoughCircles(size_t n_args, const mp_obj_t *pos_args, mp_ma
     int minRadius = args[ARG_minRadius].u_int;
     int maxRadius = args[ARG_maxRadius].u_int;
 
+    // HoughCircles() merges the results of its parallel stripes under a
+    // cv::Mutex, which does nothing because OpenCV is built without thread
+    // support, so it must only run on one core
+    int numThreads = getNumThreads();
+    setNumThreads(1);
+
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         HoughCircles(image, circles, method, dp, minDist, param1, param2, minRadius, maxRadius);
     } catch(Exception& e) {
+        setNumThreads(numThreads);
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
+    setNumThreads(numThreads);
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(circles);
 }
 
 mp_obj_t cv2_imgproc_HoughCirclesWithAccumulator(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_method, ARG_dp, ARG_minDist, ARG_circles, ARG_param1, ARG_param2, ARG_minRadius, ARG_maxRadius };
     static const mp_arg_t allowed_args[] = {
@@ -1288,14 +1685,24 @@ mp_obj_t cv2_imgproc_HoughCirclesWithAccumulator(size_t n_args, const mp_obj_t *
     // Vector to hold the circles and votes
     std::vector<Vec4f> circles_acc;
 
+    // HoughCircles() merges the results of its parallel stripes under a
+    // cv::Mutex, which does nothing because OpenCV is built without thread
+    // support, so it must only run on one core
+    int numThreads = getNumThreads();
+    setNumThreads(1);
+
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         HoughCircles(image, circles_acc, method, dp, minDist, param1, param2, minRadius, maxRadius);
     } catch(Exception& e) {
+        setNumThreads(numThreads);
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
+    setNumThreads(numThreads);
 
     // Copy the vector of circles and votes to output circles object
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     Mat(circles_acc).copyTo(circles);
 
     // Return the result
@@ -1303,6 +1710,8 @@ mp_obj_t cv2_imgproc_HoughCirclesWithAccumulator(size_t n_args, const mp_obj_t *
 }
 
 mp_obj_t cv2_imgproc_HoughLines(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_rho, ARG_theta, ARG_threshold, ARG_lines, ARG_srn, ARG_stn, ARG_min_theta, ARG_max_theta, ARG_use_edgeval };
     static const mp_arg_t allowed_args[] = {
@@ -1359,6 +1768,7 @@ mp_obj_t cv2_imgproc_HoughLines(size_t n_args, const mp_obj_t *pos_args, mp_map_
     bool use_edgeval = args[ARG_use_edgeval].u_bool;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         HoughLines(image, lines, rho, theta, threshold, srn, stn, min_theta, max_theta, use_edgeval);
     } catch(Exception& e) {
@@ -1366,10 +1776,13 @@ mp_obj_t cv2_imgproc_HoughLines(size_t n_args, const mp_obj_t *pos_args, mp_map_
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(lines);
 }
 
 mp_obj_t cv2_imgproc_HoughLinesP(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_rho, ARG_theta, ARG_threshold, ARG_lines, ARG_minLineLength, ARG_maxLineGap };
     static const mp_arg_t allowed_args[] = {
@@ -1404,6 +1817,7 @@ mp_obj_t cv2_imgproc_HoughLinesP(size_t n_args, const mp_obj_t *pos_args, mp_map
         maxLineGap = mp_obj_get_float(args[ARG_maxLineGap].u_obj);  
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         HoughLinesP(image, lines32S, rho, theta, threshold, minLineLength, maxLineGap);
     } catch(Exception& e) {
@@ -1411,6 +1825,7 @@ mp_obj_t cv2_imgproc_HoughLinesP(size_t n_args, const mp_obj_t *pos_args, mp_map
     }
 
     // Convert lines to float
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     Mat lines;
     lines.allocator = &GetNumpyAllocator();
     lines32S.convertTo(lines, CV_32F);
@@ -1420,6 +1835,8 @@ mp_obj_t cv2_imgproc_HoughLinesP(size_t n_args, const mp_obj_t *pos_args, mp_map
 }
 
 mp_obj_t cv2_imgproc_HoughLinesWithAccumulator(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_image, ARG_rho, ARG_theta, ARG_threshold, ARG_lines, ARG_srn, ARG_stn, ARG_min_theta, ARG_max_theta };
     static const mp_arg_t allowed_args[] = {
@@ -1477,6 +1894,7 @@ mp_obj_t cv2_imgproc_HoughLinesWithAccumulator(size_t n_args, const mp_obj_t *po
     std::vector<Vec3f> lines_acc;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         HoughLines(image, lines_acc, rho, theta, threshold, srn, stn, min_theta, max_theta);
     } catch(Exception& e) {
@@ -1484,6 +1902,7 @@ mp_obj_t cv2_imgproc_HoughLinesWithAccumulator(size_t n_args, const mp_obj_t *po
     }
 
     // Copy the vector of lines and votes to output lines object
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     Mat(lines_acc).copyTo(lines);
 
     // Return the result
@@ -1491,6 +1910,8 @@ mp_obj_t cv2_imgproc_HoughLinesWithAccumulator(size_t n_args, const mp_obj_t *po
 }
 
 mp_obj_t cv2_imgproc_isContourConvex(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_contour };
     static const mp_arg_t allowed_args[] = {
@@ -1502,10 +1923,11 @@ mp_obj_t cv2_imgproc_isContourConvex(size_t n_args, const mp_obj_t *pos_args, mp
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat contour = mp_obj_to_mat(args[ARG_contour].u_obj);
+    Mat contour = mp_obj_to_points(args[ARG_contour].u_obj);
 
     // Call the corresponding OpenCV function
     bool isConvex;
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         isConvex = isContourConvex(contour);
     } catch(Exception& e) {
@@ -1513,10 +1935,13 @@ mp_obj_t cv2_imgproc_isContourConvex(size_t n_args, const mp_obj_t *pos_args, mp
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mp_obj_new_bool(isConvex);
 }
 
 mp_obj_t cv2_imgproc_Laplacian(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_ddepth, ARG_dst, ARG_ksize, ARG_scale, ARG_delta, ARG_borderType };
     static const mp_arg_t allowed_args[] = {
@@ -1543,17 +1968,24 @@ mp_obj_t cv2_imgproc_Laplacian(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     int borderType = args[ARG_borderType].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        Laplacian(src, dst, ddepth, ksize, scale, delta, borderType);
+        dst.create(src.size(), CV_MAKETYPE(ddepth < 0 ? src.depth() : ddepth, src.channels()));
+        parallel_filter(src, dst, borderType, std::max(1, ksize / 2), [&](Mat s, Mat d) {
+            Laplacian(s, d, ddepth, ksize, scale, delta, borderType);
+        });
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_line(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_pt1, ARG_pt2, ARG_color, ARG_thickness, ARG_lineType, ARG_shift };
     static const mp_arg_t allowed_args[] = {
@@ -1580,6 +2012,7 @@ mp_obj_t cv2_imgproc_line(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
     int shift = args[ARG_shift].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         line(img, pt1, pt2, color, thickness, lineType, shift);
     } catch(Exception& e) {
@@ -1587,10 +2020,13 @@ mp_obj_t cv2_imgproc_line(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgproc_matchShapes(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_contour1, ARG_contour2, ARG_method, ARG_parameter };
     static const mp_arg_t allowed_args[] = {
@@ -1605,14 +2041,15 @@ mp_obj_t cv2_imgproc_matchShapes(size_t n_args, const mp_obj_t *pos_args, mp_map
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat contour1 = mp_obj_to_mat(args[ARG_contour1].u_obj);
-    Mat contour2 = mp_obj_to_mat(args[ARG_contour2].u_obj);
+    Mat contour1 = mp_obj_to_points(args[ARG_contour1].u_obj);
+    Mat contour2 = mp_obj_to_points(args[ARG_contour2].u_obj);
     int method = args[ARG_method].u_int;
     mp_float_t parameter = mp_obj_get_float(args[ARG_parameter].u_obj);
 
     mp_float_t retval;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = matchShapes(contour1, contour2, method, parameter);
     } catch(Exception& e) {
@@ -1620,10 +2057,13 @@ mp_obj_t cv2_imgproc_matchShapes(size_t n_args, const mp_obj_t *pos_args, mp_map
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mp_obj_new_float(retval);
 }
 
 mp_obj_t cv2_imgproc_matchTemplate(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_templ, ARG_method, ARG_result, ARG_mask };
     static const mp_arg_t allowed_args[] = {
@@ -1646,6 +2086,7 @@ mp_obj_t cv2_imgproc_matchTemplate(size_t n_args, const mp_obj_t *pos_args, mp_m
     Mat mask = mp_obj_to_mat(args[ARG_mask].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         matchTemplate(img, templ, result, method, mask);
     } catch(Exception& e) {
@@ -1653,10 +2094,13 @@ mp_obj_t cv2_imgproc_matchTemplate(size_t n_args, const mp_obj_t *pos_args, mp_m
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(result);
 }
 
 mp_obj_t cv2_imgproc_medianBlur(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_ksize, ARG_dst };
     static const mp_arg_t allowed_args[] = {
@@ -1675,6 +2119,7 @@ mp_obj_t cv2_imgproc_medianBlur(size_t n_args, const mp_obj_t *pos_args, mp_map_
     Mat dst = mp_obj_to_mat(args[ARG_dst].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         medianBlur(src, dst, ksize);
     } catch(Exception& e) {
@@ -1682,10 +2127,13 @@ mp_obj_t cv2_imgproc_medianBlur(size_t n_args, const mp_obj_t *pos_args, mp_map_
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_minAreaRect(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_points };
     static const mp_arg_t allowed_args[] = {
@@ -1697,11 +2145,12 @@ mp_obj_t cv2_imgproc_minAreaRect(size_t n_args, const mp_obj_t *pos_args, mp_map
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat points = mp_obj_to_mat(args[ARG_points].u_obj);
+    Mat points = mp_obj_to_points(args[ARG_points].u_obj);
 
     RotatedRect retval;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = minAreaRect(points);
     } catch(Exception& e) {
@@ -1709,6 +2158,7 @@ mp_obj_t cv2_imgproc_minAreaRect(size_t n_args, const mp_obj_t *pos_args, mp_map
     }
 
     // Return the result as a tuple
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t center_tuple[2];
     center_tuple[0] = mp_obj_new_float(retval.center.x);
     center_tuple[1] = mp_obj_new_float(retval.center.y);
@@ -1723,6 +2173,8 @@ mp_obj_t cv2_imgproc_minAreaRect(size_t n_args, const mp_obj_t *pos_args, mp_map
 }
 
 mp_obj_t cv2_imgproc_minEnclosingCircle(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_points };
     static const mp_arg_t allowed_args[] = {
@@ -1734,12 +2186,13 @@ mp_obj_t cv2_imgproc_minEnclosingCircle(size_t n_args, const mp_obj_t *pos_args,
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat points = mp_obj_to_mat(args[ARG_points].u_obj);
+    Mat points = mp_obj_to_points(args[ARG_points].u_obj);
 
     Point2f center;
     float radius;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         minEnclosingCircle(points, center, radius);
     } catch(Exception& e) {
@@ -1747,6 +2200,7 @@ mp_obj_t cv2_imgproc_minEnclosingCircle(size_t n_args, const mp_obj_t *pos_args,
     }
 
     // Return the result as a tuple
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t center_tuple[2];
     center_tuple[0] = mp_obj_new_float(center.x);
     center_tuple[1] = mp_obj_new_float(center.y);
@@ -1757,6 +2211,8 @@ mp_obj_t cv2_imgproc_minEnclosingCircle(size_t n_args, const mp_obj_t *pos_args,
 }
 
 mp_obj_t cv2_imgproc_minEnclosingTriangle(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_points, ARG_triangle };
     static const mp_arg_t allowed_args[] = {
@@ -1769,12 +2225,13 @@ mp_obj_t cv2_imgproc_minEnclosingTriangle(size_t n_args, const mp_obj_t *pos_arg
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat points = mp_obj_to_mat(args[ARG_points].u_obj);
+    Mat points = mp_obj_to_points(args[ARG_points].u_obj);
     Mat triangle = mp_obj_to_mat(args[ARG_triangle].u_obj);
 
     mp_float_t retval;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = minEnclosingTriangle(points, triangle);
     } catch(Exception& e) {
@@ -1782,6 +2239,7 @@ mp_obj_t cv2_imgproc_minEnclosingTriangle(size_t n_args, const mp_obj_t *pos_arg
     }
 
     // Return the result as a tuple
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t result_tuple[2];
     result_tuple[0] = mp_obj_new_float(retval);
     result_tuple[1] = mat_to_mp_obj(triangle);
@@ -1789,6 +2247,8 @@ mp_obj_t cv2_imgproc_minEnclosingTriangle(size_t n_args, const mp_obj_t *pos_arg
 }
 
 mp_obj_t cv2_imgproc_moments(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_binary };
     static const mp_arg_t allowed_args[] = {
@@ -1806,44 +2266,21 @@ mp_obj_t cv2_imgproc_moments(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     Moments moments;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         moments = cv::moments(src, binary);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
     
-    // Create a dictionary to hold the moments
-    mp_obj_t moments_dict = mp_obj_new_dict(0);
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m00), mp_obj_new_float(moments.m00));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m10), mp_obj_new_float(moments.m10));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m01), mp_obj_new_float(moments.m01));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m20), mp_obj_new_float(moments.m20));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m11), mp_obj_new_float(moments.m11));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m02), mp_obj_new_float(moments.m02));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m30), mp_obj_new_float(moments.m30));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m21), mp_obj_new_float(moments.m21));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m12), mp_obj_new_float(moments.m12));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_m03), mp_obj_new_float(moments.m03));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu20), mp_obj_new_float(moments.mu20));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu11), mp_obj_new_float(moments.mu11));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu02), mp_obj_new_float(moments.mu02));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu30), mp_obj_new_float(moments.mu30));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu21), mp_obj_new_float(moments.mu21));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu12), mp_obj_new_float(moments.mu12));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_mu03), mp_obj_new_float(moments.mu03));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu20), mp_obj_new_float(moments.nu20));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu11), mp_obj_new_float(moments.nu11));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu02), mp_obj_new_float(moments.nu02));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu30), mp_obj_new_float(moments.nu30));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu21), mp_obj_new_float(moments.nu21));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu12), mp_obj_new_float(moments.nu12));
-    mp_obj_dict_store(moments_dict, MP_OBJ_NEW_QSTR(MP_QSTR_nu03), mp_obj_new_float(moments.nu03));
-
-    // Return the moments dictionary
-    return moments_dict;
+    // Return the moments as a dictionary
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return moments_to_mp_obj(moments);
 }
 
 mp_obj_t cv2_imgproc_morphologyEx(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_op, ARG_kernel, ARG_dst, ARG_anchor, ARG_iterations, ARG_borderType, ARG_borderValue };
     static const mp_arg_t allowed_args[] = {
@@ -1880,6 +2317,7 @@ mp_obj_t cv2_imgproc_morphologyEx(size_t n_args, const mp_obj_t *pos_args, mp_ma
         borderValue = mp_obj_to_scalar(args[ARG_borderValue].u_obj);
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         morphologyEx(src, dst, op, kernel, anchor, iterations, borderType, borderValue);
     } catch(Exception& e) {
@@ -1887,10 +2325,13 @@ mp_obj_t cv2_imgproc_morphologyEx(size_t n_args, const mp_obj_t *pos_args, mp_ma
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_pointPolygonTest(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_contour, ARG_pt, ARG_measureDist };
     static const mp_arg_t allowed_args[] = {
@@ -1904,13 +2345,14 @@ mp_obj_t cv2_imgproc_pointPolygonTest(size_t n_args, const mp_obj_t *pos_args, m
     mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
 
     // Convert arguments to required types
-    Mat contour = mp_obj_to_mat(args[ARG_contour].u_obj);
+    Mat contour = mp_obj_to_points(args[ARG_contour].u_obj);
     Point pt = mp_obj_to_point(args[ARG_pt].u_obj);
     bool measureDist = args[ARG_measureDist].u_bool;
 
     mp_float_t retval;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         retval = pointPolygonTest(contour, pt, measureDist);
     } catch(Exception& e) {
@@ -1918,10 +2360,13 @@ mp_obj_t cv2_imgproc_pointPolygonTest(size_t n_args, const mp_obj_t *pos_args, m
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mp_obj_new_float(retval);
 }
 
 mp_obj_t cv2_imgproc_putText(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_text, ARG_org, ARG_fontFace, ARG_fontScale, ARG_color, ARG_thickness, ARG_lineType, ARG_bottomLeftOrigin };
     static const mp_arg_t allowed_args[] = {
@@ -1954,6 +2399,7 @@ mp_obj_t cv2_imgproc_putText(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     bool bottomLeftOrigin = args[ARG_bottomLeftOrigin].u_bool;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         putText(img, text, org, fontFace, fontScale, color, thickness, lineType, bottomLeftOrigin);
     } catch(Exception& e) {
@@ -1961,10 +2407,13 @@ mp_obj_t cv2_imgproc_putText(size_t n_args, const mp_obj_t *pos_args, mp_map_t *
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgproc_rectangle(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_img, ARG_pt1, ARG_pt2, ARG_color, ARG_thickness, ARG_lineType, ARG_shift };
     static const mp_arg_t allowed_args[] = {
@@ -1991,6 +2440,7 @@ mp_obj_t cv2_imgproc_rectangle(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     int shift = args[ARG_shift].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         rectangle(img, pt1, pt2, color, thickness, lineType, shift);
     } catch(Exception& e) {
@@ -1998,10 +2448,13 @@ mp_obj_t cv2_imgproc_rectangle(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(img);
 }
 
 mp_obj_t cv2_imgproc_Scharr(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_ddepth, ARG_dx, ARG_dy, ARG_dst, ARG_scale, ARG_delta, ARG_borderType };
     static const mp_arg_t allowed_args[] = {
@@ -2030,17 +2483,24 @@ mp_obj_t cv2_imgproc_Scharr(size_t n_args, const mp_obj_t *pos_args, mp_map_t *k
     int borderType = args[ARG_borderType].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        Scharr(src, dst, ddepth, dx, dy, scale, delta, borderType);
+        dst.create(src.size(), CV_MAKETYPE(ddepth < 0 ? src.depth() : ddepth, src.channels()));
+        parallel_filter(src, dst, borderType, 1, [&](Mat s, Mat d) {
+            Scharr(s, d, ddepth, dx, dy, scale, delta, borderType);
+        });
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_Sobel(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_ddepth, ARG_dx, ARG_dy, ARG_dst, ARG_ksize, ARG_scale, ARG_delta, ARG_borderType };
     static const mp_arg_t allowed_args[] = {
@@ -2071,17 +2531,24 @@ mp_obj_t cv2_imgproc_Sobel(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw
     int borderType = args[ARG_borderType].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        Sobel(src, dst, ddepth, dx, dy, ksize, scale, delta, borderType);
+        dst.create(src.size(), CV_MAKETYPE(ddepth < 0 ? src.depth() : ddepth, src.channels()));
+        parallel_filter(src, dst, borderType, std::max(1, ksize / 2), [&](Mat s, Mat d) {
+            Sobel(s, d, ddepth, dx, dy, ksize, scale, delta, borderType);
+        });
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     return mat_to_mp_obj(dst);
 }
 
 mp_obj_t cv2_imgproc_spatialGradient(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_dx, ARG_dy, ARG_ksize, ARG_borderType };
     static const mp_arg_t allowed_args[] = {
@@ -2104,6 +2571,7 @@ mp_obj_t cv2_imgproc_spatialGradient(size_t n_args, const mp_obj_t *pos_args, mp
     int borderType = args[ARG_borderType].u_int;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
         spatialGradient(src, dx, dy, ksize, borderType);
     } catch(Exception& e) {
@@ -2111,13 +2579,33 @@ mp_obj_t cv2_imgproc_spatialGradient(size_t n_args, const mp_obj_t *pos_args, mp
     }
 
     // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t result[2];
     result[0] = mat_to_mp_obj(dx);
     result[1] = mat_to_mp_obj(dy);
     return mp_obj_new_tuple(2, result);
 }
 
+double op_threshold(const Mat& src, Mat& dst, double thresh, double maxval, int type)
+{
+    // Otsu's and the triangle methods compute the threshold from the whole
+    // image, so can't be split into bands
+    if(type & (THRESH_OTSU | THRESH_TRIANGLE))
+        return threshold(src, dst, thresh, maxval, type);
+
+    double retval = thresh;
+    dst.create(src.size(), src.type());
+    parallel_pointwise(src, dst, [&](Mat s, Mat d) {
+        double t = threshold(s, d, thresh, maxval, type);
+        if(s.data == src.data)
+            retval = t;
+    });
+    return retval;
+}
+
 mp_obj_t cv2_imgproc_threshold(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
     // Define the arguments
     enum { ARG_src, ARG_thresh, ARG_maxval, ARG_type, ARG_dst };
     static const mp_arg_t allowed_args[] = {
@@ -2142,13 +2630,15 @@ mp_obj_t cv2_imgproc_threshold(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     mp_float_t retval;
 
     // Call the corresponding OpenCV function
+    CV2_PROFILE_PHASE(COMPUTE);
     try {
-        retval = threshold(src, dst, thresh, maxval, type);
+        retval = op_threshold(src, dst, thresh, maxval, type);
     } catch(Exception& e) {
         mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
     }
 
     // Return the result as a tuple
+    CV2_PROFILE_PHASE(CONVERT_OUT);
     mp_obj_t result_tuple[2];
     result_tuple[0] = mp_obj_new_float(retval);
     result_tuple[1] = mat_to_mp_obj(dst);
@@ -10,10 +10,18 @@
  *------------------------------------------------------------------------------
  */
 
+#include "alloc.h"
+#include "bind.h"
+#include "bitmask.h"
+#include "classifier.h"
 #include "core.h"
 #include "highgui.h"
 #include "imgcodecs.h"
 #include "imgproc.h"
+#include "pipeline.h"
+#include "pool.h"
+#include "profile.h"
+#include "rle.h"
 
 // Python module globals dictionary
 static const mp_rom_map_elem_t cv2_module_globals_table[] = {
@@ -21,10 +29,18 @@ static const mp_rom_map_elem_t cv2_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_cv2) },
 
     // Inlude globals from each OpenCV module
+    OPENCV_ALLOC_GLOBALS,
+    OPENCV_BIND_GLOBALS,
+    OPENCV_BITMASK_GLOBALS,
+    OPENCV_CLASSIFIER_GLOBALS,
     OPENCV_CORE_GLOBALS,
     OPENCV_HIGHGUI_GLOBALS,
     OPENCV_IMGCODECS_GLOBALS,
     OPENCV_IMGPROC_GLOBALS,
+    OPENCV_PIPELINE_GLOBALS,
+    OPENCV_POOL_GLOBALS,
+    OPENCV_PROFILE_GLOBALS,
+    OPENCV_RLE_GLOBALS,
 };
 static MP_DEFINE_CONST_DICT(cv2_module_globals, cv2_module_globals_table);
 
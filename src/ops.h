@@ -0,0 +1,47 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * ops.h
+ * 
+ * OpenCV calls shared by the cv2 wrappers and by bound operations (see
+ * bind.cpp). These take OpenCV types, split the work into bands of rows where
+ * possible, and throw an Exception on errors like OpenCV does.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+
+using namespace cv;
+
+// Defined in core.cpp
+void op_inRange(const Mat& src, const Mat& lower, const Mat& upper, Mat& dst);
+
+// inRange() bounds for an image of the given size and type, converted once so
+// rows of the image can be classified one at a time with op_inRange_row(),
+// without converting the bounds again for every row
+struct InRangeBounds
+{
+    Mat lower;
+    Mat upper;
+    bool lower_rows;
+    bool upper_rows;
+    bool packed;
+    uchar lo[4];
+    uchar hi[4];
+};
+InRangeBounds op_inRange_bounds(Size size, int type, const Mat& lower, const Mat& upper);
+void op_inRange_row(const InRangeBounds& bounds, const Mat& src, int y, Mat& dst);
+
+// Defined in imgproc.cpp
+bool is_bayer_code(int code);
+void op_blur(const Mat& src, Mat& dst, Size ksize, Point anchor, int borderType);
+void op_cvtColor(const Mat& src, Mat& dst, int code);
+void op_dilate(const Mat& src, Mat& dst, const Mat& kernel, Point anchor, int iterations, int borderType, const Scalar& borderValue);
+void op_erode(const Mat& src, Mat& dst, const Mat& kernel, Point anchor, int iterations, int borderType, const Scalar& borderValue);
+int gaussian_halo(int ksize, double sigma);
+void op_GaussianBlur(const Mat& src, Mat& dst, Size ksize, double sigmaX, double sigmaY, int borderType, AlgorithmHint hint);
+double op_threshold(const Mat& src, Mat& dst, double thresh, double maxval, int type);
@@ -0,0 +1,414 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * parallel.cpp
+ * 
+ * OpenCV parallel_for_() backend that uses both cores of the RP2350, or a
+ * worker thread on Linux, plus helpers to split operations into bands of rows.
+ * 
+ * OpenCV is built with OPENCV_DISABLE_THREAD_SUPPORT, which removes its own
+ * threading frameworks, but it still hands every parallel_for_() to a custom
+ * backend if one is registered. Each parallel_for_() is posted as a job, and
+ * the caller and the worker both take stripes from it until none are left. If
+ * the worker isn't available, the caller simply processes every stripe.
+ * 
+ * cv::Mutex is a no-op without thread support, so functions that merge the
+ * results of their stripes under one (Canny() and HoughCircles() among the
+ * wrapped functions) are run with one thread by their wrappers.
+ * 
+ * The worker must not touch the MicroPython GC, because the GC is not aware of
+ * it (and on the RP2350 it has no MicroPython thread state). alloc.c checks
+ * cv2_parallel_in_worker() to send its allocations to the C heap instead.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "parallel.h"
+#include <atomic>
+#include <cstring>
+#include <exception>
+
+#if defined(PICO_ON_DEVICE) && PICO_ON_DEVICE
+#include "pico/multicore.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+#define CV2_PARALLEL_WORKER_CORE1 1
+#elif defined(__unix__)
+#include <pthread.h>
+#define CV2_PARALLEL_WORKER_PTHREAD 1
+#endif
+
+// C headers
+extern "C" {
+// Defined in alloc.c
+void alloc_set_parallel(bool parallel);
+} // extern "C"
+
+// State of the job shared between the caller and the worker
+enum {
+    JOB_IDLE,
+    JOB_POSTED,
+    JOB_TAKEN,
+    JOB_DONE,
+};
+
+// Everything shared with the worker is static, which keeps it in SRAM. Atomic
+// operations do not work in PSRAM on the RP2350, see rp2350_cv_xadd.h
+static std::atomic<int> job_state(JOB_IDLE);
+static std::atomic<int> job_next(0);
+static int job_tasks = 0;
+static parallel::ParallelForAPI::FN_parallel_for_body_cb_t job_body = nullptr;
+static void* job_data = nullptr;
+static volatile bool job_failed = false;
+
+// Processes stripes from the current job until there are none left. This is
+// run by both the caller and the worker
+static void run_stripes()
+{
+    int i;
+    while((i = job_next.fetch_add(1)) < job_tasks)
+        job_body(i, i + 1, job_data);
+}
+
+#if CV2_PARALLEL_WORKER_CORE1
+
+// Stack for core 1. The default core 1 stack is too small for some OpenCV
+// functions
+#ifndef CV2_PARALLEL_STACK_SIZE
+#define CV2_PARALLEL_STACK_SIZE 8192
+#endif
+static uint32_t worker_stack[CV2_PARALLEL_STACK_SIZE / sizeof(uint32_t)];
+
+static bool worker_running = false;
+static volatile bool worker_active = false;
+static volatile uint32_t worker_heartbeat = 0;
+
+static bool in_worker()
+{
+    return worker_active && get_core_num() == 1;
+}
+
+// Takes the posted job, unless the caller has already finished it. This and
+// worker_main() run from RAM, so core 1 never executes from flash while it's
+// idle. The caller is blocked in parallel_for() while the stripes run, so it
+// can't be writing to flash at the same time
+static void __not_in_flash_func(worker_run_job)()
+{
+    int expected = JOB_POSTED;
+    if(!job_state.compare_exchange_strong(expected, JOB_TAKEN))
+        return;
+    worker_active = true;
+    try {
+        run_stripes();
+    } catch(...) {
+        job_failed = true;
+    }
+    worker_active = false;
+    job_state.store(JOB_DONE);
+    __sev();
+}
+
+static void __not_in_flash_func(worker_main)()
+{
+    while(true) {
+        worker_heartbeat = worker_heartbeat + 1;
+        if(job_state.load() == JOB_POSTED)
+            worker_run_job();
+        else
+            __wfe();
+    }
+}
+
+static bool worker_start()
+{
+    if(worker_running)
+        return true;
+
+    // The _thread module also runs on core 1, and makes it a multicore lockout
+    // victim so flash can be written safely. Never take core 1 away from it
+    if(multicore_lockout_victim_is_initialized(1))
+        return false;
+
+    multicore_reset_core1();
+    multicore_launch_core1_with_stack(worker_main, worker_stack, sizeof(worker_stack));
+    worker_running = true;
+    return true;
+}
+
+static void worker_notify()
+{
+    __sev();
+}
+
+static void worker_wait_done()
+{
+    while(job_state.load() != JOB_DONE)
+        __wfe();
+}
+
+// Called when the worker didn't take a job. It normally wakes up immediately,
+// so if the heartbeat doesn't change, core 1 was reset (eg. by a soft reset)
+// and the worker needs to be started again
+static void worker_missed(uint32_t heartbeat)
+{
+    absolute_time_t timeout = make_timeout_time_us(100);
+    while(worker_heartbeat == heartbeat) {
+        if(time_reached(timeout)) {
+            worker_running = false;
+            return;
+        }
+    }
+}
+
+static uint32_t worker_get_heartbeat()
+{
+    return worker_heartbeat;
+}
+
+#elif CV2_PARALLEL_WORKER_PTHREAD
+
+static bool worker_running = false;
+static pthread_t worker_thread;
+static pthread_mutex_t worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t worker_cond = PTHREAD_COND_INITIALIZER;
+static thread_local bool worker_self = false;
+
+static bool in_worker()
+{
+    return worker_self;
+}
+
+static void worker_run_job()
+{
+    int expected = JOB_POSTED;
+    if(!job_state.compare_exchange_strong(expected, JOB_TAKEN))
+        return;
+    try {
+        run_stripes();
+    } catch(...) {
+        job_failed = true;
+    }
+    job_state.store(JOB_DONE);
+}
+
+static void* worker_main(void*)
+{
+    worker_self = true;
+    pthread_mutex_lock(&worker_mutex);
+    while(true) {
+        while(job_state.load() != JOB_POSTED)
+            pthread_cond_wait(&worker_cond, &worker_mutex);
+        pthread_mutex_unlock(&worker_mutex);
+        worker_run_job();
+        pthread_mutex_lock(&worker_mutex);
+        pthread_cond_broadcast(&worker_cond);
+    }
+    return nullptr;
+}
+
+static bool worker_start()
+{
+    if(!worker_running)
+        worker_running = pthread_create(&worker_thread, nullptr, worker_main, nullptr) == 0;
+    return worker_running;
+}
+
+static void worker_notify()
+{
+    pthread_mutex_lock(&worker_mutex);
+    pthread_cond_broadcast(&worker_cond);
+    pthread_mutex_unlock(&worker_mutex);
+}
+
+static void worker_wait_done()
+{
+    pthread_mutex_lock(&worker_mutex);
+    while(job_state.load() != JOB_DONE)
+        pthread_cond_wait(&worker_cond, &worker_mutex);
+    pthread_mutex_unlock(&worker_mutex);
+}
+
+// A thread doesn't disappear, so a missed job just means the caller was faster
+static void worker_missed(uint32_t heartbeat) {}
+
+static uint32_t worker_get_heartbeat()
+{
+    return 0;
+}
+
+#else
+
+// No worker on this platform, so everything runs on the caller
+static bool in_worker() { return false; }
+static bool worker_start() { return false; }
+static void worker_notify() {}
+static void worker_wait_done() {}
+static void worker_missed(uint32_t heartbeat) {}
+static uint32_t worker_get_heartbeat() { return 0; }
+
+#endif
+
+void UpyParallelForAPI::parallel_for(int tasks, FN_parallel_for_body_cb_t body_callback, void* callback_data)
+{
+    if(tasks < 2 || numThreads < 2 || in_worker() || !worker_start())
+    {
+        body_callback(0, tasks, callback_data);
+        return;
+    }
+
+    // Post the job
+    job_body = body_callback;
+    job_data = callback_data;
+    job_tasks = tasks;
+    job_next.store(0);
+    job_failed = false;
+    uint32_t heartbeat = worker_get_heartbeat();
+    alloc_set_parallel(true);
+    job_state.store(JOB_POSTED);
+    worker_notify();
+
+    // Help out. OpenCV catches exceptions inside each stripe, but the worker
+    // must be finished with the job before anything gets unwound
+    std::exception_ptr error;
+    try {
+        run_stripes();
+    } catch(...) {
+        error = std::current_exception();
+    }
+
+    // Withdraw the job if the worker never took it, otherwise wait for it
+    int expected = JOB_POSTED;
+    if(job_state.compare_exchange_strong(expected, JOB_IDLE))
+    {
+        worker_missed(heartbeat);
+    }
+    else
+    {
+        worker_wait_done();
+        job_state.store(JOB_IDLE);
+    }
+    alloc_set_parallel(false);
+
+    if(error)
+        std::rethrow_exception(error);
+    if(job_failed)
+        CV_Error(Error::StsError, "Parallel worker failed");
+}
+
+int UpyParallelForAPI::getThreadNum() const
+{
+    return in_worker() ? 1 : 0;
+}
+
+int UpyParallelForAPI::getNumThreads() const
+{
+    return numThreads;
+}
+
+int UpyParallelForAPI::setNumThreads(int nThreads)
+{
+    // Same convention as cv::setNumThreads(): 0 disables threading, and a
+    // negative number restores the default
+    if(nThreads < 0)
+        numThreads = CV2_PARALLEL_MAX_THREADS;
+    else if(nThreads == 0)
+        numThreads = 1;
+    else
+        numThreads = std::min(nThreads, CV2_PARALLEL_MAX_THREADS);
+    return numThreads;
+}
+
+const char* UpyParallelForAPI::getName() const
+{
+    return "upy";
+}
+
+void upyParallelInit()
+{
+    parallel::setParallelForBackend(std::make_shared<UpyParallelForAPI>());
+}
+
+// extern "C" so alloc.c can use it
+extern "C" bool cv2_parallel_in_worker(void)
+{
+    return in_worker();
+}
+
+void parallel_rows(int rows, const std::function<void(const Range&)>& fn)
+{
+    int nstripes = std::min(getNumThreads(), rows / CV2_PARALLEL_MIN_BAND_ROWS);
+    if(nstripes < 2)
+        fn(Range(0, rows));
+    else
+        parallel_for_(Range(0, rows), fn, nstripes);
+}
+
+void parallel_pointwise(const Mat& src, Mat& dst, const std::function<void(Mat, Mat)>& fn)
+{
+    parallel_rows(src.rows, [&](const Range& r) {
+        fn(src.rowRange(r), dst.rowRange(r));
+    });
+}
+
+// Returns true if the memory used by two Mats overlaps
+static bool mats_overlap(const Mat& a, const Mat& b)
+{
+    return a.datastart < b.dataend && b.datastart < a.dataend;
+}
+
+int filter_halo(int rows, int anchor)
+{
+    if(anchor < 0)
+        anchor = rows / 2;
+    return std::max(anchor, rows - 1 - anchor);
+}
+
+// Runs a neighborhood operation in place, when src and dst are the same image.
+// The bands are processed from the top, and each one is copied into a buffer
+// along with halo rows of context on each side before it gets overwritten.
+// The rows above a band have already been overwritten by then, so they're
+// carried over from the end of the previous band's buffer. The bands depend on
+// each other, so this runs on one core
+static void inplace_filter(const Mat& src, Mat& dst, int halo, const std::function<void(Mat, Mat)>& fn)
+{
+    Mat buf(CV2_PARALLEL_INPLACE_ROWS + 2 * halo, src.cols, src.type());
+
+    // Rows [top, bottom) of src are in buf
+    int top = 0;
+    int bottom = 0;
+    for(int y0 = 0; y0 < src.rows; y0 += CV2_PARALLEL_INPLACE_ROWS)
+    {
+        int y1 = std::min(src.rows, y0 + CV2_PARALLEL_INPLACE_ROWS);
+        int new_top = std::max(0, y0 - halo);
+        int new_bottom = std::min(src.rows, y1 + halo);
+
+        // Carry over the rows that are still needed, then copy the rest
+        if(bottom > new_top)
+            memmove(buf.data, buf.ptr(new_top - top), (bottom - new_top) * buf.step[0]);
+        else
+            bottom = new_top;
+        src.rowRange(bottom, new_bottom).copyTo(buf.rowRange(bottom - new_top, new_bottom - new_top));
+        top = new_top;
+        bottom = new_bottom;
+
+        // The header ends at the last row in buf, so rows past it are
+        // extrapolated, which only happens at the edges of the image
+        Mat in(bottom - top, src.cols, src.type(), buf.data, buf.step[0]);
+        fn(in.rowRange(y0 - top, y1 - top), dst.rowRange(y0, y1));
+    }
+}
+
+void parallel_filter(const Mat& src, Mat& dst, int borderType, int halo, const std::function<void(Mat, Mat)>& fn)
+{
+    if(borderType & BORDER_ISOLATED)
+        fn(src, dst);
+    else if(src.data == dst.data && src.step[0] == dst.step[0] && src.size() == dst.size())
+        inplace_filter(src, dst, halo, fn);
+    else if(mats_overlap(src, dst))
+        fn(src, dst);
+    else
+        parallel_pointwise(src, dst, fn);
+}
@@ -0,0 +1,71 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * parallel.h
+ * 
+ * OpenCV parallel_for_() backend that uses both cores of the RP2350, or a
+ * worker thread on Linux, plus helpers to split operations into bands of rows.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+#include "opencv2/core/parallel/parallel_backend.hpp"
+#include <functional>
+
+using namespace cv;
+
+// Maximum number of threads, including the caller
+#define CV2_PARALLEL_MAX_THREADS 2
+
+// Bands smaller than this are not worth handing to another core
+#define CV2_PARALLEL_MIN_BAND_ROWS 16
+
+// Rows per band when a filter runs in place
+#define CV2_PARALLEL_INPLACE_ROWS 32
+
+// Splits each parallel_for_() into stripes, which get processed by both the
+// calling core and a worker on the other core
+class UpyParallelForAPI : public parallel::ParallelForAPI
+{
+public:
+    UpyParallelForAPI() : numThreads(CV2_PARALLEL_MAX_THREADS) {}
+    ~UpyParallelForAPI() {}
+
+    void parallel_for(int tasks, FN_parallel_for_body_cb_t body_callback, void* callback_data) CV_OVERRIDE;
+    int getThreadNum() const CV_OVERRIDE;
+    int getNumThreads() const CV_OVERRIDE;
+    int setNumThreads(int nThreads) CV_OVERRIDE;
+    const char* getName() const CV_OVERRIDE;
+
+    int numThreads;
+};
+
+// Registers the backend with OpenCV. Must be called from upyOpenCVBoot(), so
+// the backend gets allocated on the C heap
+void upyParallelInit();
+
+// Runs fn over the rows [0, rows), split into one band per thread. Each band
+// is processed by a separate call, so fn must only write to the rows it's given
+void parallel_rows(int rows, const std::function<void(const Range&)>& fn);
+
+// Runs a pixel-wise operation on bands of rows. dst must already be allocated
+// with the same number of rows as src
+void parallel_pointwise(const Mat& src, Mat& dst, const std::function<void(Mat, Mat)>& fn);
+
+// Rows of context a filter with a kernel of the given height needs on each
+// side of a row. A negative anchor is the center of the kernel
+int filter_halo(int rows, int anchor);
+
+// Runs a neighborhood operation (eg. a filter) on bands of rows. Each band is
+// passed as a ROI of the full image, so OpenCV reads neighboring pixels from
+// the other bands instead of extrapolating the border. halo is how many rows
+// of context fn needs on each side of a row, see filter_halo(). If src and dst
+// are the same image, the bands are processed in place on one core, through a
+// buffer of a few rows. Falls back to a single call if the border is isolated,
+// or if src and dst partially overlap. dst must already be allocated with the
+// same number of rows as src
+void parallel_filter(const Mat& src, Mat& dst, int borderType, int halo, const std::function<void(Mat, Mat)>& fn);
@@ -0,0 +1,34 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * pipeline.c
+ * 
+ * Type of cv2.Pipeline. The type is defined in C, since MicroPython's type
+ * macros don't compile as C++. Everything else is in pipeline.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "pipeline.h"
+
+// Defined in pipeline.cpp
+extern mp_obj_t cv2_pipeline_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args);
+extern mp_obj_t cv2_pipeline_Pipeline_run(mp_obj_t self_in, mp_obj_t frame);
+
+static MP_DEFINE_CONST_FUN_OBJ_2(cv2_pipeline_Pipeline_run_obj, cv2_pipeline_Pipeline_run);
+
+static const mp_rom_map_elem_t cv2_pipeline_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_run), MP_ROM_PTR(&cv2_pipeline_Pipeline_run_obj) },
+};
+static MP_DEFINE_CONST_DICT(cv2_pipeline_locals_dict, cv2_pipeline_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    cv2_pipeline_type,
+    MP_QSTR_Pipeline,
+    MP_TYPE_FLAG_NONE,
+    make_new, cv2_pipeline_make_new,
+    locals_dict, &cv2_pipeline_locals_dict
+    );
@@ -0,0 +1,347 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * pipeline.cpp
+ * 
+ * Pipelines of bound operations. cv2.Pipeline(stages) takes a list of stages,
+ * each a bound operation (see bind.cpp) or a (function, kwargs) tuple that gets
+ * bound, and run(frame) passes the frame through every stage without returning
+ * to Python in between.
+ * 
+ * Each stage writes into its own buffer, which is its bound dst if it has one,
+ * or an ndarray allocated the first time the pipeline runs. The buffers are
+ * kept for the next frame, and only reallocated if a stage's output changes
+ * size or type, so a steady-state loop allocates nothing for the intermediate
+ * images.
+ * 
+ * With strip_rows, the image stages instead run on horizontal strips of the
+ * frame, and each strip passes through every stage before the next one
+ * starts. The intermediate images then only exist one strip at a time, so they
+ * stay in the cache (or in SRAM, when frames are in PSRAM) between stages,
+ * instead of each stage streaming a whole frame out to memory and back. Only
+ * the output of the last image stage is a full image. Filters need rows of
+ * context above and below each strip (see BoundOp::halo()), so each stage
+ * computes a few more rows than the next one needs, which get recomputed by
+ * the neighboring strip. The strips are split between the cores, each with its
+ * own set of strip buffers.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+#include "bound.h"
+#include "convert.h"
+#include "numpy.h"
+#include "parallel.h"
+#include "profile_scope.h"
+#include <new>
+
+// C headers
+extern "C" {
+#include "pipeline.h"
+} // extern "C"
+
+using namespace cv;
+
+// A pipeline. bufs[i] is the output of stage i, as a header over the ndarray
+// buf_objs[i], see bound_run(). When running on strips, n_image stages run on
+// strips, reach[i] is how many rows the strips of stage i extend beyond the
+// output strip on each side, and strips holds CV2_PARALLEL_MAX_THREADS sets of
+// strip buffers for stages 0 to n_image - 2, allocated for frames of
+// strip_src_type and strip_src_cols
+struct cv2_pipeline_obj_t
+{
+    mp_obj_base_t base;
+    size_t n_stages;
+    cv2_bound_obj_t** stages;
+    mp_obj_t* buf_objs;
+    Mat* bufs;
+    int strip_rows;
+    size_t n_image;
+    int* reach;
+    mp_obj_t* strip_objs;
+    Mat* strips;
+    int strip_src_type;
+    int strip_src_cols;
+    int strip_dst_type;
+};
+
+// Returns a stage of a pipeline as a bound operation, binding it if needed
+static cv2_bound_obj_t* pipeline_stage(mp_obj_t spec)
+{
+    cv2_bound_obj_t* stage = bound_from_mp_obj(spec);
+    if(stage != nullptr)
+        return stage;
+
+    // (function, kwargs) tuples, where kwargs is a dict of the arguments
+    if(mp_obj_is_type(spec, &mp_type_tuple))
+    {
+        mp_obj_tuple_t *tuple = (mp_obj_tuple_t*) MP_OBJ_TO_PTR(spec);
+        if(tuple->len == 1)
+        {
+            mp_map_t no_kwargs;
+            mp_map_init(&no_kwargs, 0);
+            return bound_from_mp_obj(bound_new(tuple->items[0], &no_kwargs));
+        }
+        if(tuple->len == 2 && mp_obj_is_type(tuple->items[1], &mp_type_dict))
+        {
+            mp_obj_dict_t *kwargs = (mp_obj_dict_t*) MP_OBJ_TO_PTR(tuple->items[1]);
+            return bound_from_mp_obj(bound_new(tuple->items[0], &kwargs->map));
+        }
+    }
+    mp_raise_TypeError(MP_ERROR_TEXT("Pipeline stages must be bound functions or (function, kwargs) tuples"));
+}
+
+// Allocates an ndarray for a buffer, unless it already has the right size and
+// type. The buffer is kept as a header over the ndarray, like in bound_run()
+static void pipeline_alloc(Mat& buf, mp_obj_t& buf_obj, int rows, int cols, int type)
+{
+    if(buf.rows == rows && buf.cols == cols && buf.type() == type)
+        return;
+    Mat mat;
+    mat.allocator = &GetNumpyAllocator();
+    mat.create(rows, cols, type);
+    ndarray_obj_t *ndarray = mat_to_ndarray(mat);
+    buf_obj = MP_OBJ_FROM_PTR(ndarray);
+    buf = ndarray_to_mat_header(ndarray);
+}
+
+// Allocates the strip buffers for frames like src. The type of each stage's
+// output is found by passing the first row of src through every stage, which
+// also catches conversions that change the size of the image
+static void pipeline_alloc_strips(cv2_pipeline_obj_t* self, const Mat& src)
+{
+    size_t n = self->n_image;
+    int* types = m_new(int, n);
+    try {
+        Mat row = src.rowRange(0, 1);
+        for(size_t i = 0; i < n; i++)
+        {
+            Mat out;
+            self->stages[i]->op->run(self->stages[i], row, out);
+            if(out.rows != 1 || out.cols != src.cols)
+                CV_Error(Error::StsBadSize, "Pipeline stages must keep the image size to run on strips");
+            types[i] = out.type();
+            row = out;
+        }
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    for(size_t set = 0; set < CV2_PARALLEL_MAX_THREADS; set++)
+    {
+        for(size_t i = 0; i + 1 < n; i++)
+        {
+            size_t k = set * self->n_stages + i;
+            pipeline_alloc(self->strips[k], self->strip_objs[k], self->strip_rows + 2 * self->reach[i], src.cols, types[i]);
+        }
+    }
+    self->strip_src_type = src.type();
+    self->strip_src_cols = src.cols;
+    self->strip_dst_type = types[n - 1];
+}
+
+// Runs the image stages on rows [y0, y1) of the output, using one set of strip
+// buffers. Returns the retval of the last image stage
+static double pipeline_run_strip(cv2_pipeline_obj_t* self, const Mat& src, Mat& dst, Mat* strips, int y0, int y1)
+{
+    size_t n = self->n_image;
+    double retval = 0;
+
+    // Rows of the previous stage's output that are in its strip buffer. The
+    // first stage reads from the whole frame
+    Mat in = src;
+    int in_y0 = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+        // Rows this stage computes
+        int r0 = std::max(0, y0 - self->reach[i]);
+        int r1 = std::min(src.rows, y1 + self->reach[i]);
+
+        // The input is a ROI of the previous strip, so filters read the rows of
+        // context from it. The strip header ends at its last valid row, so
+        // rows past it are extrapolated like the edges of the image
+        Mat s = in.rowRange(r0 - in_y0, r1 - in_y0);
+        Mat d;
+        if(i + 1 < n)
+            d = Mat(r1 - r0, src.cols, strips[i].type(), strips[i].data, strips[i].step);
+        else
+            d = dst.rowRange(r0, r1);
+        uchar* data = d.data;
+        retval = self->stages[i]->op->run(self->stages[i], s, d);
+        CV_Assert(d.data == data);
+
+        in = d;
+        in_y0 = r0;
+    }
+    return retval;
+}
+
+// Runs the image stages on strips, writing the output of the last one to
+// bufs[n_image - 1]
+static double pipeline_run_strips(cv2_pipeline_obj_t* self, const Mat& src)
+{
+    size_t n = self->n_image;
+    if(src.type() != self->strip_src_type || src.cols != self->strip_src_cols)
+        pipeline_alloc_strips(self, src);
+    pipeline_alloc(self->bufs[n - 1], self->buf_objs[n - 1], src.rows, src.cols, self->strip_dst_type);
+    Mat& dst = self->bufs[n - 1];
+
+    // Split the strips into one contiguous group per thread, so each group
+    // can use its own set of strip buffers
+    int n_strips = (src.rows + self->strip_rows - 1) / self->strip_rows;
+    int n_groups = std::min(std::min(getNumThreads(), n_strips), CV2_PARALLEL_MAX_THREADS);
+    double retval = 0;
+    try {
+        auto run_groups = [&](const Range& groups) {
+            for(int g = groups.start; g < groups.end; g++)
+            {
+                Mat* strips = self->strips + g * self->n_stages;
+                int first = g * n_strips / n_groups;
+                int last = (g + 1) * n_strips / n_groups;
+                for(int j = first; j < last; j++)
+                {
+                    int y0 = j * self->strip_rows;
+                    int y1 = std::min(src.rows, y0 + self->strip_rows);
+                    double t = pipeline_run_strip(self, src, dst, strips, y0, y1);
+                    if(j == 0)
+                        retval = t;
+                }
+            }
+        };
+        if(n_groups < 2)
+            run_groups(Range(0, 1));
+        else
+            parallel_for_(Range(0, n_groups), run_groups, n_groups);
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+    return retval;
+}
+
+extern "C" mp_obj_t cv2_pipeline_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    // Define the arguments
+    enum { ARG_stages, ARG_strip_rows };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_stages, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_strip_rows, MP_ARG_KW_ONLY | MP_ARG_INT, { .u_int = 0 } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t parsed[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, args, MP_ARRAY_SIZE(allowed_args), allowed_args, parsed);
+    int strip_rows = parsed[ARG_strip_rows].u_int;
+    if(strip_rows < 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("strip_rows must not be negative"));
+    }
+
+    // Assume the stages are a list or tuple. Will raise an exception if not
+    size_t n_stages;
+    mp_obj_t *specs;
+    mp_obj_get_array(parsed[ARG_stages].u_obj, &n_stages, &specs);
+    if(n_stages == 0)
+    {
+        mp_raise_ValueError(MP_ERROR_TEXT("Pipeline needs at least one stage"));
+    }
+
+    cv2_pipeline_obj_t *self = m_new_obj(cv2_pipeline_obj_t);
+    self->base.type = type;
+    self->n_stages = n_stages;
+    self->stages = m_new(cv2_bound_obj_t*, n_stages);
+    self->buf_objs = m_new(mp_obj_t, n_stages);
+    self->bufs = (Mat*) m_malloc(n_stages * sizeof(Mat));
+    self->strip_rows = strip_rows;
+    self->n_image = n_stages;
+    self->reach = nullptr;
+    self->strip_objs = nullptr;
+    self->strips = nullptr;
+    self->strip_src_type = -1;
+    self->strip_src_cols = -1;
+    self->strip_dst_type = -1;
+
+    // Validate the stages, and start each buffer at the stage's bound dst
+    for(size_t i = 0; i < n_stages; i++)
+    {
+        cv2_bound_obj_t* stage = pipeline_stage(specs[i]);
+        if(stage->op->finish != nullptr)
+        {
+            if(i != n_stages - 1)
+            {
+                mp_raise_ValueError(MP_ERROR_TEXT("Only the last stage can output something other than an image"));
+            }
+            self->n_image = i;
+        }
+        self->stages[i] = stage;
+        self->buf_objs[i] = stage->dst_obj;
+        new (&self->bufs[i]) Mat(stage->dst);
+    }
+
+    // Find how far the strips of each stage reach beyond the output strip,
+    // which is the sum of the halos of every stage after it
+    if(strip_rows > 0 && self->n_image > 0)
+    {
+        size_t n = self->n_image;
+        self->reach = m_new(int, n);
+        int reach = 0;
+        for(size_t i = n; i-- > 0;)
+        {
+            self->reach[i] = reach;
+            cv2_bound_obj_t* stage = self->stages[i];
+            int halo = stage->op->halo == nullptr ? -1 : stage->op->halo(stage);
+            if(halo < 0)
+            {
+                mp_raise_ValueError(MP_ERROR_TEXT("Pipeline stage can't run on strips"));
+            }
+            reach += halo;
+        }
+
+        size_t n_strips = CV2_PARALLEL_MAX_THREADS * n_stages;
+        self->strip_objs = m_new(mp_obj_t, n_strips);
+        self->strips = (Mat*) m_malloc(n_strips * sizeof(Mat));
+        for(size_t k = 0; k < n_strips; k++)
+        {
+            self->strip_objs[k] = mp_const_none;
+            new (&self->strips[k]) Mat();
+        }
+    }
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+extern "C" mp_obj_t cv2_pipeline_Pipeline_run(mp_obj_t self_in, mp_obj_t frame) {
+    CV2_PROFILE_FUNCTION();
+
+    cv2_pipeline_obj_t *self = (cv2_pipeline_obj_t*) MP_OBJ_TO_PTR(self_in);
+
+    // Only the frame needs converting
+    Mat src = bound_src(frame);
+
+    // Run each stage on the output of the previous one, either on strips or
+    // on whole images
+    CV2_PROFILE_PHASE(COMPUTE);
+    double retval = 0;
+    size_t i = 0;
+    if(self->strips != nullptr && !src.empty())
+    {
+        i = self->n_image;
+        retval = pipeline_run_strips(self, src);
+        src = self->bufs[i - 1];
+    }
+    for(; i < self->n_stages; i++)
+    {
+        cv2_bound_obj_t* stage = self->stages[i];
+        if(stage->op->finish != nullptr)
+            return stage->op->finish(stage, src);
+        retval = bound_run(stage, src, self->bufs[i], self->buf_objs[i]);
+        src = self->bufs[i];
+    }
+
+    // Return the result of the last stage
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    size_t last = self->n_stages - 1;
+    return bound_result(self->stages[last], self->buf_objs[last], retval);
+}
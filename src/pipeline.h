@@ -0,0 +1,22 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * pipeline.h
+ * 
+ * MicroPython wrappers for pipelines of bound operations, see pipeline.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Type definitions, see pipeline.c
+extern const mp_obj_type_t cv2_pipeline_type;
+
+// Global definitions for functions and constants
+#define OPENCV_PIPELINE_GLOBALS \
+    /* Types */ \
+    { MP_ROM_QSTR(MP_QSTR_Pipeline), MP_ROM_PTR(&cv2_pipeline_type) }
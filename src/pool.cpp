@@ -0,0 +1,240 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * pool.cpp
+ * 
+ * Mat buffer pool, see pool_allocator.h. Freed buffers are kept in buckets by
+ * their exact size in bytes, and linked through their first word while they
+ * wait. A steady-state video loop allocates the same few sizes every frame, so
+ * exact sizes match well, and there's no need to split or merge buffers.
+ * 
+ * Pooled buffers are still tracked allocations (see alloc.c), so the GC never
+ * frees them. A soft reset frees the whole GC heap though, so alloc.c calls
+ * cv2_pool_forget() when that happens.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "pool_allocator.h"
+#include <cstdlib>
+#include <new>
+
+// C headers
+extern "C" {
+#include "pool.h"
+// Defined in alloc.c
+void* alloc_malloc_outside_arena(size_t size);
+bool gc_inited(void);
+bool gc_owns(const void* ptr);
+bool alloc_watch_soft_reset(void);
+// Defined in parallel.cpp
+bool cv2_parallel_in_worker(void);
+} // extern "C"
+
+// Freed buffers of one size
+struct PoolBucket
+{
+    size_t size;
+    void* head;
+    int count;
+};
+
+static PoolBucket pool_buckets[CV2_POOL_BUCKETS];
+static size_t pool_bytes = 0;
+static size_t pool_buffers = 0;
+static size_t pool_hits = 0;
+static size_t pool_misses = 0;
+
+// Returns the bucket for a size, or an empty bucket if there's none yet and
+// create is true, or nullptr
+static PoolBucket* pool_bucket(size_t size, bool create)
+{
+    PoolBucket* empty = nullptr;
+    for(int i = 0; i < CV2_POOL_BUCKETS; i++)
+    {
+        if(pool_buckets[i].size == size)
+            return &pool_buckets[i];
+        if(empty == nullptr && pool_buckets[i].count == 0)
+            empty = &pool_buckets[i];
+    }
+    if(!create || empty == nullptr)
+        return nullptr;
+    empty->size = size;
+    return empty;
+}
+
+static bool pool_usable(size_t size)
+{
+    return size >= CV2_POOL_MIN_SIZE && gc_inited() && !cv2_parallel_in_worker();
+}
+
+// Gives every pooled buffer back to the GC
+static void pool_drain()
+{
+    for(int i = 0; i < CV2_POOL_BUCKETS; i++)
+    {
+        while(pool_buckets[i].head != nullptr)
+        {
+            void* ptr = pool_buckets[i].head;
+            pool_buckets[i].head = *(void**)ptr;
+            fastFree(ptr);
+        }
+        pool_buckets[i] = PoolBucket();
+    }
+    pool_bytes = 0;
+    pool_buffers = 0;
+}
+
+// Returns a buffer of the given size, from the pool if possible
+static uchar* pool_take(size_t size)
+{
+    if(pool_usable(size))
+    {
+        PoolBucket* bucket = pool_bucket(size, false);
+        if(bucket != nullptr && bucket->count > 0)
+        {
+            void* ptr = bucket->head;
+            bucket->head = *(void**)ptr;
+            bucket->count--;
+            pool_buffers--;
+            pool_bytes -= size;
+            pool_hits++;
+            return (uchar*)ptr;
+        }
+        pool_misses++;
+    }
+
+    // Idle buffers of other sizes may be what's keeping the allocation from
+    // fitting, so if it fails, give them all back to the GC and try once more
+    try
+    {
+        return (uchar*)fastMalloc(size);
+    }
+    catch(Exception&)
+    {
+        if(pool_buffers == 0 || !gc_inited() || cv2_parallel_in_worker())
+            throw;
+    }
+    pool_drain();
+    return (uchar*)fastMalloc(size);
+}
+
+// Keeps a buffer in the pool if there's room, otherwise frees it
+static void pool_give(void* ptr, size_t size)
+{
+    if(pool_usable(size) && gc_owns(ptr) && pool_bytes + size <= CV2_POOL_MAX_BYTES
+        && alloc_watch_soft_reset())
+    {
+        PoolBucket* bucket = pool_bucket(size, true);
+        if(bucket != nullptr && bucket->count < CV2_POOL_BUCKET_DEPTH)
+        {
+            *(void**)ptr = bucket->head;
+            bucket->head = ptr;
+            bucket->count++;
+            pool_buffers++;
+            pool_bytes += size;
+            return;
+        }
+    }
+    fastFree(ptr);
+}
+
+// Derived from StdMatAllocator::allocate(), see:
+// https://github.com/opencv/opencv/blob/4.x/modules/core/src/matrix.cpp
+UMatData* PoolAllocator::allocate(int dims, const int* sizes, int type, void* data0, size_t* step, AccessFlag /*flags*/, UMatUsageFlags /*usageFlags*/) const
+{
+    size_t total = CV_ELEM_SIZE(type);
+    for(int i = dims - 1; i >= 0; i--)
+    {
+        if(step)
+        {
+            if(data0 && step[i] != CV_AUTOSTEP)
+            {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            }
+            else
+                step[i] = total;
+        }
+        total *= sizes[i];
+    }
+    uchar* data = data0 ? (uchar*)data0 : pool_take(total);
+
+    // The UMatData stays out of the scratch arena, so the Mat can be handed to
+    // Python without copying it, see mat_wrap_ndarray() in convert.cpp
+    void* mem = alloc_malloc_outside_arena(sizeof(UMatData));
+    if(mem == nullptr)
+    {
+        if(!data0)
+            pool_give(data, total);
+        CV_Error(Error::StsNoMem, "Failed to allocate UMatData");
+    }
+    UMatData* u = new(mem) UMatData(this);
+    u->data = u->origdata = data;
+    u->size = total;
+    if(data0)
+        u->flags |= UMatData::USER_ALLOCATED;
+
+    return u;
+}
+
+bool PoolAllocator::allocate(UMatData* u, AccessFlag /*accessFlags*/, UMatUsageFlags /*usageFlags*/) const
+{
+    if(!u) return false;
+    return true;
+}
+
+void PoolAllocator::deallocate(UMatData* u) const
+{
+    if(!u)
+        return;
+
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    if(!(u->flags & UMatData::USER_ALLOCATED))
+    {
+        pool_give(u->origdata, u->size);
+        u->origdata = 0;
+    }
+    u->~UMatData();
+    free(u);
+}
+
+// Called by alloc.c on a soft reset, after which the pooled buffers no longer
+// exist. extern "C" so alloc.c can use it
+extern "C" void cv2_pool_forget(void)
+{
+    for(int i = 0; i < CV2_POOL_BUCKETS; i++)
+        pool_buckets[i] = PoolBucket();
+    pool_bytes = 0;
+    pool_buffers = 0;
+}
+
+static void pool_store(mp_obj_t dict, qstr key, size_t value)
+{
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(key), mp_obj_new_int_from_uint(value));
+}
+
+// Returns a dict with the number of allocations served from the pool (hits)
+// and not (misses), and the number of buffers and bytes currently pooled
+mp_obj_t cv2_pool_stats(void)
+{
+    mp_obj_t stats = mp_obj_new_dict(4);
+    pool_store(stats, MP_QSTR_hits, pool_hits);
+    pool_store(stats, MP_QSTR_misses, pool_misses);
+    pool_store(stats, MP_QSTR_buffers, pool_buffers);
+    pool_store(stats, MP_QSTR_bytes, pool_bytes);
+    return stats;
+}
+
+// Gives every pooled buffer back to the GC, and resets the counters
+mp_obj_t cv2_pool_clear(void)
+{
+    pool_drain();
+    pool_hits = 0;
+    pool_misses = 0;
+    return mp_const_none;
+}
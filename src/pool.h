@@ -0,0 +1,28 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * pool.h
+ * 
+ * MicroPython wrappers for the Mat buffer pool kept by pool.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Function declarations
+extern mp_obj_t cv2_pool_stats(void);
+extern mp_obj_t cv2_pool_clear(void);
+
+// Python references to the functions
+static MP_DEFINE_CONST_FUN_OBJ_0(cv2_pool_stats_obj, cv2_pool_stats);
+static MP_DEFINE_CONST_FUN_OBJ_0(cv2_pool_clear_obj, cv2_pool_clear);
+
+// Global definitions for functions and constants
+#define OPENCV_POOL_GLOBALS \
+    /* Functions */ \
+    { MP_ROM_QSTR(MP_QSTR_pool_stats), MP_ROM_PTR(&cv2_pool_stats_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_pool_clear), MP_ROM_PTR(&cv2_pool_clear_obj) }
@@ -0,0 +1,55 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * pool_allocator.h
+ * 
+ * OpenCV Mat allocator that keeps freed buffers and hands them back out for
+ * the next Mat of the same size, so a video loop that allocates the same
+ * temporaries every frame reuses them instead of going through the GC.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+
+using namespace cv;
+
+// Buffers smaller than this come from the scratch arena in alloc.c, which is
+// already cheap, so they're not pooled
+#ifndef CV2_POOL_MIN_SIZE
+#define CV2_POOL_MIN_SIZE 4096
+#endif
+
+// Maximum number of bytes kept in the pool. Buffers freed beyond that are
+// given back to the GC
+#ifndef CV2_POOL_MAX_BYTES
+#define CV2_POOL_MAX_BYTES (1024 * 1024)
+#endif
+
+// Number of distinct buffer sizes, and buffers of each size, kept in the pool
+#ifndef CV2_POOL_BUCKETS
+#define CV2_POOL_BUCKETS 16
+#endif
+#ifndef CV2_POOL_BUCKET_DEPTH
+#define CV2_POOL_BUCKET_DEPTH 4
+#endif
+
+// Same as StdMatAllocator, except the buffers come from, and go back to, the
+// pool. Only buffers on the GC heap that are allocated and freed by the caller
+// get pooled. The parallel worker must not touch the pool, so it uses
+// fastMalloc() and fastFree() directly, like StdMatAllocator
+class PoolAllocator : public MatAllocator
+{
+public:
+    PoolAllocator() {}
+    ~PoolAllocator() {}
+
+    UMatData* allocate(int dims, const int* sizes, int type, void* data0, size_t* step, AccessFlag flags, UMatUsageFlags usageFlags) const CV_OVERRIDE;
+    bool allocate(UMatData* u, AccessFlag accessFlags, UMatUsageFlags usageFlags) const CV_OVERRIDE;
+    void deallocate(UMatData* u) const CV_OVERRIDE;
+};
+
+inline PoolAllocator& GetPoolAllocator() {static PoolAllocator gPoolAllocator;return gPoolAllocator;}
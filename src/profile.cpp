@@ -0,0 +1,137 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * profile.cpp
+ * 
+ * Per-function profiling counters for the cv2 wrappers, see profile_scope.h.
+ * The counters are only kept when the module is built with
+ * MICROPY_PY_CV2_PROFILE, otherwise cv2.profile() returns an empty dict.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "profile_scope.h"
+#include <cstring>
+
+// C headers
+extern "C" {
+#include "profile.h"
+#include "py/mphal.h"
+// Defined in alloc.c
+void alloc_get_stats(size_t* count, size_t* bytes);
+} // extern "C"
+
+// List of every wrapper that has been called at least once
+static Cv2ProfileEntry* profile_entries = nullptr;
+
+Cv2ProfileScope::Cv2ProfileScope(Cv2ProfileEntry& entry) : entry(entry), current(CV2_PROFILE_CONVERT_IN), phase_us()
+{
+    if(!entry.registered)
+    {
+        entry.next = profile_entries;
+        entry.registered = true;
+        profile_entries = &entry;
+    }
+    alloc_get_stats(&start_alloc_count, &start_alloc_bytes);
+    start_us = phase_start_us = mp_hal_ticks_us();
+}
+
+void Cv2ProfileScope::phase(int next)
+{
+    uint32_t now = mp_hal_ticks_us();
+    phase_us[current] += now - phase_start_us;
+    current = next;
+    phase_start_us = now;
+}
+
+Cv2ProfileScope::~Cv2ProfileScope()
+{
+    phase(current);
+
+    uint32_t total = 0;
+    for(int i = 0; i < CV2_PROFILE_NUM_PHASES; i++)
+    {
+        total += phase_us[i];
+        entry.phase_total_us[i] += phase_us[i];
+        if(phase_us[i] > entry.phase_max_us[i])
+            entry.phase_max_us[i] = phase_us[i];
+    }
+    entry.calls++;
+    entry.total_us += total;
+    if(total > entry.max_us)
+        entry.max_us = total;
+
+    size_t alloc_count, alloc_bytes;
+    alloc_get_stats(&alloc_count, &alloc_bytes);
+    entry.alloc_count += alloc_count - start_alloc_count;
+    entry.alloc_bytes += alloc_bytes - start_alloc_bytes;
+}
+
+// Strips the module prefix from a wrapper's name, eg. cv2_imgproc_Canny
+// becomes Canny
+static const char* profile_name(const char* name)
+{
+    const char* p = strchr(name, '_');
+    if(p != nullptr)
+        p = strchr(p + 1, '_');
+    return p != nullptr ? p + 1 : name;
+}
+
+static void profile_store(mp_obj_t dict, qstr key, uint64_t value)
+{
+    mp_obj_dict_store(dict, MP_OBJ_NEW_QSTR(key), mp_obj_new_int_from_ull(value));
+}
+
+// Returns a dict with the counters of every wrapper that has been called since
+// the last reset, keyed by function name
+mp_obj_t cv2_profile(void)
+{
+    static const qstr phase_total_keys[CV2_PROFILE_NUM_PHASES] = {
+        MP_QSTR_convert_in_us, MP_QSTR_compute_us, MP_QSTR_convert_out_us,
+    };
+    static const qstr phase_max_keys[CV2_PROFILE_NUM_PHASES] = {
+        MP_QSTR_convert_in_max_us, MP_QSTR_compute_max_us, MP_QSTR_convert_out_max_us,
+    };
+
+    mp_obj_t result = mp_obj_new_dict(0);
+    for(Cv2ProfileEntry* entry = profile_entries; entry != nullptr; entry = entry->next)
+    {
+        if(entry->calls == 0)
+            continue;
+
+        mp_obj_t stats = mp_obj_new_dict(5 + 2 * CV2_PROFILE_NUM_PHASES);
+        profile_store(stats, MP_QSTR_calls, entry->calls);
+        profile_store(stats, MP_QSTR_total_us, entry->total_us);
+        profile_store(stats, MP_QSTR_max_us, entry->max_us);
+        for(int i = 0; i < CV2_PROFILE_NUM_PHASES; i++)
+        {
+            profile_store(stats, phase_total_keys[i], entry->phase_total_us[i]);
+            profile_store(stats, phase_max_keys[i], entry->phase_max_us[i]);
+        }
+        profile_store(stats, MP_QSTR_alloc_count, entry->alloc_count);
+        profile_store(stats, MP_QSTR_alloc_bytes, entry->alloc_bytes);
+
+        const char* name = profile_name(entry->name);
+        mp_obj_dict_store(result, mp_obj_new_str(name, strlen(name)), stats);
+    }
+    return result;
+}
+
+// Clears every counter. Wrappers stay in the list, but are skipped by
+// cv2.profile() until they're called again
+mp_obj_t cv2_profile_reset(void)
+{
+    for(Cv2ProfileEntry* entry = profile_entries; entry != nullptr; entry = entry->next)
+    {
+        Cv2ProfileEntry* next = entry->next;
+        const char* name = entry->name;
+        *entry = Cv2ProfileEntry();
+        entry->name = name;
+        entry->next = next;
+        entry->registered = true;
+    }
+    return mp_const_none;
+}
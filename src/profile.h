@@ -0,0 +1,29 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * profile.h
+ * 
+ * MicroPython wrappers for the per-function profiling counters kept by
+ * profile.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Function declarations
+extern mp_obj_t cv2_profile(void);
+extern mp_obj_t cv2_profile_reset(void);
+
+// Python references to the functions
+static MP_DEFINE_CONST_FUN_OBJ_0(cv2_profile_obj, cv2_profile);
+static MP_DEFINE_CONST_FUN_OBJ_0(cv2_profile_reset_obj, cv2_profile_reset);
+
+// Global definitions for functions and constants
+#define OPENCV_PROFILE_GLOBALS \
+    /* Functions */ \
+    { MP_ROM_QSTR(MP_QSTR_profile), MP_ROM_PTR(&cv2_profile_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_profile_reset), MP_ROM_PTR(&cv2_profile_reset_obj) }
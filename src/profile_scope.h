@@ -0,0 +1,83 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * profile_scope.h
+ * 
+ * Instrumentation for the cv2 wrappers. Each wrapper starts with
+ * CV2_PROFILE_FUNCTION(), then marks where the OpenCV call starts and where the
+ * result starts being converted back to Python objects. The counters are read
+ * with cv2.profile().
+ * 
+ * This is only compiled in when MICROPY_PY_CV2_PROFILE is set, otherwise the
+ * macros expand to nothing.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include <cstddef>
+#include <cstdint>
+
+#ifndef MICROPY_PY_CV2_PROFILE
+#define MICROPY_PY_CV2_PROFILE (0)
+#endif
+
+// Phases of a wrapper call
+enum {
+    // Parsing arguments and converting them to OpenCV types
+    CV2_PROFILE_CONVERT_IN,
+    // Calling OpenCV
+    CV2_PROFILE_COMPUTE,
+    // Converting the results to Python objects
+    CV2_PROFILE_CONVERT_OUT,
+    CV2_PROFILE_NUM_PHASES,
+};
+
+// Counters for one wrapper. These are static in each wrapper, and get linked
+// into a list the first time the wrapper is called
+struct Cv2ProfileEntry
+{
+    const char* name;
+    Cv2ProfileEntry* next;
+    bool registered;
+    uint32_t calls;
+    uint64_t total_us;
+    uint32_t max_us;
+    uint64_t phase_total_us[CV2_PROFILE_NUM_PHASES];
+    uint32_t phase_max_us[CV2_PROFILE_NUM_PHASES];
+    uint64_t alloc_count;
+    uint64_t alloc_bytes;
+};
+
+// Times one call of a wrapper. The counters are updated when this goes out of
+// scope, so calls that raise an exception are not counted
+class Cv2ProfileScope
+{
+public:
+    Cv2ProfileScope(Cv2ProfileEntry& entry);
+    ~Cv2ProfileScope();
+
+    // Ends the current phase and starts the next one
+    void phase(int next);
+
+private:
+    Cv2ProfileEntry& entry;
+    int current;
+    uint32_t start_us;
+    uint32_t phase_start_us;
+    uint32_t phase_us[CV2_PROFILE_NUM_PHASES];
+    size_t start_alloc_count;
+    size_t start_alloc_bytes;
+};
+
+#if MICROPY_PY_CV2_PROFILE
+#define CV2_PROFILE_FUNCTION() \
+    static Cv2ProfileEntry cv2_profile_entry = { __func__ }; \
+    Cv2ProfileScope cv2_profile_scope(cv2_profile_entry)
+#define CV2_PROFILE_PHASE(p) cv2_profile_scope.phase(CV2_PROFILE_##p)
+#else
+#define CV2_PROFILE_FUNCTION() do {} while(0)
+#define CV2_PROFILE_PHASE(p) do {} while(0)
+#endif
@@ -0,0 +1,48 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * rle.c
+ * 
+ * Type of cv2.RLEMask. The type is defined in C, since MicroPython's type
+ * macros don't compile as C++. Everything else is in rle.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "rle.h"
+
+// Defined in rle.cpp
+extern mp_obj_t cv2_rle_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args);
+extern void cv2_rle_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest);
+extern mp_obj_t cv2_rle_RLEMask_area(mp_obj_t self_in);
+extern mp_obj_t cv2_rle_RLEMask_boundingRect(mp_obj_t self_in);
+extern mp_obj_t cv2_rle_RLEMask_connectedComponentsStats(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_rle_RLEMask_moments(mp_obj_t self_in);
+extern mp_obj_t cv2_rle_RLEMask_toArray(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+
+static MP_DEFINE_CONST_FUN_OBJ_1(cv2_rle_RLEMask_area_obj, cv2_rle_RLEMask_area);
+static MP_DEFINE_CONST_FUN_OBJ_1(cv2_rle_RLEMask_boundingRect_obj, cv2_rle_RLEMask_boundingRect);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_rle_RLEMask_connectedComponentsStats_obj, 1, cv2_rle_RLEMask_connectedComponentsStats);
+static MP_DEFINE_CONST_FUN_OBJ_1(cv2_rle_RLEMask_moments_obj, cv2_rle_RLEMask_moments);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_rle_RLEMask_toArray_obj, 1, cv2_rle_RLEMask_toArray);
+
+static const mp_rom_map_elem_t cv2_rle_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_area), MP_ROM_PTR(&cv2_rle_RLEMask_area_obj) },
+    { MP_ROM_QSTR(MP_QSTR_boundingRect), MP_ROM_PTR(&cv2_rle_RLEMask_boundingRect_obj) },
+    { MP_ROM_QSTR(MP_QSTR_connectedComponentsStats), MP_ROM_PTR(&cv2_rle_RLEMask_connectedComponentsStats_obj) },
+    { MP_ROM_QSTR(MP_QSTR_moments), MP_ROM_PTR(&cv2_rle_RLEMask_moments_obj) },
+    { MP_ROM_QSTR(MP_QSTR_toArray), MP_ROM_PTR(&cv2_rle_RLEMask_toArray_obj) },
+};
+static MP_DEFINE_CONST_DICT(cv2_rle_locals_dict, cv2_rle_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    cv2_rle_type,
+    MP_QSTR_RLEMask,
+    MP_TYPE_FLAG_NONE,
+    make_new, cv2_rle_make_new,
+    attr, cv2_rle_attr,
+    locals_dict, &cv2_rle_locals_dict
+    );
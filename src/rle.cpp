@@ -0,0 +1,438 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * rle.cpp
+ * 
+ * Run-length encoded masks. A cv2.RLEMask stores each row of a binary mask as
+ * the runs of foreground pixels in it, so a mostly empty mask takes a few
+ * bytes per row instead of one byte per pixel, and the functions that measure
+ * it only visit the runs.
+ * 
+ * cv.thresholdRLE() and cv.inRangeRLE() compute the mask one row at a time
+ * into a line buffer and encode each row straight away, so the dense mask is
+ * never allocated. The rows are split between the cores, and each core encodes
+ * its band of rows into its own buffers, which are joined at the end.
+ *------------------------------------------------------------------------------
+ */
+
+// C++ headers
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+#include "components.h"
+#include "convert.h"
+#include "numpy.h"
+#include "ops.h"
+#include "parallel.h"
+#include "profile_scope.h"
+#include <algorithm>
+#include <atomic>
+
+// C headers
+extern "C" {
+#include "rle.h"
+} // extern "C"
+
+using namespace cv;
+
+// A run-length encoded mask. The runs of row y are the pairs of [x0, x1) from
+// runs[2 * row_starts[y]] up to runs[2 * row_starts[y + 1]]
+struct cv2_rle_obj_t
+{
+    mp_obj_base_t base;
+    int rows;
+    int cols;
+    uint32_t* row_starts;
+    uint16_t* runs;
+};
+
+// The runs of a band of rows, encoded by one core. counts has the number of
+// runs in each row of the band
+struct RLEBand
+{
+    Range range;
+    std::vector<uint16_t> runs;
+    std::vector<uint32_t> counts;
+};
+
+// Encodes a mask of the given size. row_fn returns row y of the mask, which is
+// nonzero for foreground pixels, and can compute it into line, a CV_8UC1 row
+// that belongs to the calling core. Returns the bands sorted from the top
+static std::vector<RLEBand> rle_encode(int rows, int cols, const std::function<const uchar*(int, Mat&)>& row_fn)
+{
+    // Runs are stored as 16-bit coordinates, which includes cols itself
+    CV_Assert(cols <= UINT16_MAX);
+
+    std::vector<RLEBand> bands(rows / CV2_PARALLEL_MIN_BAND_ROWS + 1);
+    std::atomic<int> n_bands(0);
+    parallel_rows(rows, [&](const Range& range) {
+        RLEBand& band = bands[n_bands++];
+        band.range = range;
+        band.counts.reserve(range.size());
+        Mat line(1, cols, CV_8UC1);
+        std::vector<int> runs;
+        for(int y = range.start; y < range.end; y++)
+        {
+            runs.clear();
+            row_runs(row_fn(y, line), cols, runs);
+            band.counts.push_back(runs.size() / 2);
+            band.runs.insert(band.runs.end(), runs.begin(), runs.end());
+        }
+    });
+    bands.resize(n_bands);
+    std::sort(bands.begin(), bands.end(), [](const RLEBand& a, const RLEBand& b) {
+        return a.range.start < b.range.start;
+    });
+    return bands;
+}
+
+// Creates an RLEMask from the encoded bands of a mask
+static mp_obj_t rle_new(const mp_obj_type_t *type, int rows, int cols, const std::vector<RLEBand>& bands)
+{
+    size_t n_values = 0;
+    for(const RLEBand& band : bands)
+        n_values += band.runs.size();
+
+    cv2_rle_obj_t *self = m_new_obj(cv2_rle_obj_t);
+    self->base.type = type;
+    self->rows = rows;
+    self->cols = cols;
+    self->row_starts = m_new(uint32_t, rows + 1);
+    self->runs = m_new(uint16_t, std::max(n_values, (size_t) 1));
+
+    uint32_t start = 0;
+    self->row_starts[0] = 0;
+    for(const RLEBand& band : bands)
+    {
+        for(int i = 0; i < band.range.size(); i++)
+        {
+            start += band.counts[i];
+            self->row_starts[band.range.start + i + 1] = start;
+        }
+        std::copy(band.runs.begin(), band.runs.end(), self->runs + 2 * (start - band.runs.size() / 2));
+    }
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static cv2_rle_obj_t* rle_from_mp_obj(mp_obj_t obj)
+{
+    if(!mp_obj_is_type(obj, &cv2_rle_type))
+        mp_raise_TypeError(MP_ERROR_TEXT("Expected an RLEMask"));
+    return (cv2_rle_obj_t*) MP_OBJ_TO_PTR(obj);
+}
+
+extern "C" mp_obj_t cv2_rle_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_mask };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_mask, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t parsed[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, args, MP_ARRAY_SIZE(allowed_args), allowed_args, parsed);
+
+    // Convert arguments to required types
+    Mat mask = mp_obj_to_mat(parsed[ARG_mask].u_obj);
+
+    std::vector<RLEBand> bands;
+
+    // Encode the rows of the mask as they are
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        CV_Assert(mask.type() == CV_8UC1);
+        bands = rle_encode(mask.rows, mask.cols, [&](int y, Mat&) {
+            return mask.ptr<uchar>(y);
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return rle_new(type, mask.rows, mask.cols, bands);
+}
+
+extern "C" void cv2_rle_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    cv2_rle_obj_t *self = (cv2_rle_obj_t*) MP_OBJ_TO_PTR(self_in);
+
+    // shape is read-only, like an ndarray's. Everything else is looked up in
+    // the locals dict
+    if(dest[0] == MP_OBJ_NULL && attr == MP_QSTR_shape) {
+        mp_obj_t shape[2];
+        shape[0] = mp_obj_new_int(self->rows);
+        shape[1] = mp_obj_new_int(self->cols);
+        dest[0] = mp_obj_new_tuple(2, shape);
+    } else {
+        dest[1] = MP_OBJ_SENTINEL;
+    }
+}
+
+extern "C" mp_obj_t cv2_rle_RLEMask_area(mp_obj_t self_in) {
+    cv2_rle_obj_t *self = rle_from_mp_obj(self_in);
+
+    mp_uint_t area = 0;
+    const uint16_t* run = self->runs;
+    const uint16_t* end = self->runs + 2 * self->row_starts[self->rows];
+    for(; run < end; run += 2)
+        area += run[1] - run[0];
+    return mp_obj_new_int_from_uint(area);
+}
+
+extern "C" mp_obj_t cv2_rle_RLEMask_boundingRect(mp_obj_t self_in) {
+    cv2_rle_obj_t *self = rle_from_mp_obj(self_in);
+
+    // Like cv.boundingRect(), an empty mask gives an empty rectangle at (0, 0)
+    int left = self->cols, right = 0, top = -1, bottom = -1;
+    for(int y = 0; y < self->rows; y++) {
+        uint32_t begin = self->row_starts[y];
+        uint32_t end = self->row_starts[y + 1];
+        if(begin == end)
+            continue;
+        if(top < 0)
+            top = y;
+        bottom = y;
+
+        // Runs are sorted, so only the first and last can set the bounds
+        left = std::min(left, (int) self->runs[2 * begin]);
+        right = std::max(right, (int) self->runs[2 * end - 1]);
+    }
+
+    mp_obj_t retval_tuple[4];
+    if(top < 0) {
+        retval_tuple[0] = retval_tuple[1] = retval_tuple[2] = retval_tuple[3] = mp_obj_new_int(0);
+    } else {
+        retval_tuple[0] = mp_obj_new_int(left);
+        retval_tuple[1] = mp_obj_new_int(top);
+        retval_tuple[2] = mp_obj_new_int(right - left);
+        retval_tuple[3] = mp_obj_new_int(bottom - top + 1);
+    }
+    return mp_obj_new_tuple(4, retval_tuple);
+}
+
+extern "C" mp_obj_t cv2_rle_RLEMask_connectedComponentsStats(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    cv2_rle_obj_t *self = rle_from_mp_obj(pos_args[0]);
+
+    // Define the arguments
+    enum { ARG_connectivity, ARG_min_area };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_connectivity, MP_ARG_INT, { .u_int = 8 } },
+        { MP_QSTR_min_area, MP_ARG_INT, { .u_int = 0 } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    int connectivity = args[ARG_connectivity].u_int;
+    int min_area = args[ARG_min_area].u_int;
+
+    // Outputs, with one row per component
+    Mat stats;
+    Mat centroids;
+    stats.allocator = &GetNumpyAllocator();
+    centroids.allocator = &GetNumpyAllocator();
+
+    // Return value
+    int retval = 0;
+
+    // The runs go to the labeler as they are, see cv.connectedComponentsStats()
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        ComponentLabeler labeler(self->cols, connectivity, std::max(min_area, 1));
+        std::vector<int> runs;
+        runs.reserve(self->cols + 1);
+        for(int y = 0; y < self->rows; y++) {
+            runs.assign(self->runs + 2 * self->row_starts[y], self->runs + 2 * self->row_starts[y + 1]);
+            labeler.addRow(y, runs.data(), (int) runs.size() / 2);
+        }
+        labeler.finish();
+
+        retval = (int) labeler.components.size();
+        components_to_mats(labeler.components, stats, centroids);
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    mp_obj_t result[3];
+    result[0] = mp_obj_new_int(retval);
+    result[1] = mat_to_mp_obj(stats);
+    result[2] = mat_to_mp_obj(centroids);
+    return mp_obj_new_tuple(3, result);
+}
+
+// Sum of x^k for x in [0, n), for k = 1, 2 and 3
+static inline uint64_t power_sum1(uint64_t n) { return n * (n - 1) / 2; }
+static inline uint64_t power_sum2(uint64_t n) { return n * (n - 1) * (2 * n - 1) / 6; }
+static inline uint64_t power_sum3(uint64_t n) { return power_sum1(n) * power_sum1(n); }
+
+extern "C" mp_obj_t cv2_rle_RLEMask_moments(mp_obj_t self_in) {
+    CV2_PROFILE_FUNCTION();
+    cv2_rle_obj_t *self = rle_from_mp_obj(self_in);
+
+    // The moments of a binary image, like cv.moments(mask, binaryImage=True).
+    // The sums of x^k over a run have closed forms, so each row is reduced to
+    // four integer sums, which are then weighted by powers of y
+    CV2_PROFILE_PHASE(COMPUTE);
+    double m00 = 0, m10 = 0, m01 = 0, m20 = 0, m11 = 0, m02 = 0, m30 = 0, m21 = 0, m12 = 0, m03 = 0;
+    for(int y = 0; y < self->rows; y++) {
+        uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for(uint32_t i = self->row_starts[y]; i < self->row_starts[y + 1]; i++) {
+            uint64_t x0 = self->runs[2 * i];
+            uint64_t x1 = self->runs[2 * i + 1];
+            s0 += x1 - x0;
+            s1 += power_sum1(x1) - power_sum1(x0);
+            s2 += power_sum2(x1) - power_sum2(x0);
+            s3 += power_sum3(x1) - power_sum3(x0);
+        }
+        if(s0 == 0)
+            continue;
+        double y1 = y, y2 = y1 * y1, y3 = y2 * y1;
+        m00 += s0;
+        m10 += s1;
+        m01 += y1 * s0;
+        m20 += s2;
+        m11 += y1 * s1;
+        m02 += y2 * s0;
+        m30 += s3;
+        m21 += y1 * s2;
+        m12 += y2 * s1;
+        m03 += y3 * s0;
+    }
+    Moments moments(m00, m10, m01, m20, m11, m02, m30, m21, m12, m03);
+
+    // Return the moments as a dictionary
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return moments_to_mp_obj(moments);
+}
+
+extern "C" mp_obj_t cv2_rle_RLEMask_toArray(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+    cv2_rle_obj_t *self = rle_from_mp_obj(pos_args[0]);
+
+    // Define the arguments
+    enum { ARG_dst };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_dst, MP_ARG_OBJ, { .u_obj = mp_const_none } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat dst = mp_obj_to_mat(args[ARG_dst].u_obj);
+
+    // Foreground pixels are set to 255, like the masks from cv.inRange()
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        dst.create(self->rows, self->cols, CV_8UC1);
+        parallel_rows(self->rows, [&](const Range& range) {
+            for(int y = range.start; y < range.end; y++) {
+                uchar* row = dst.ptr<uchar>(y);
+                memset(row, 0, self->cols);
+                for(uint32_t i = self->row_starts[y]; i < self->row_starts[y + 1]; i++)
+                    memset(row + self->runs[2 * i], 255, self->runs[2 * i + 1] - self->runs[2 * i]);
+            }
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return mat_to_mp_obj(dst);
+}
+
+mp_obj_t cv2_rle_inRangeRLE(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_src, ARG_lower, ARG_upper };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_lower, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_upper, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat src = mp_obj_to_mat(args[ARG_src].u_obj);
+    Mat lower = mp_obj_to_mat(args[ARG_lower].u_obj);
+    Mat upper = mp_obj_to_mat(args[ARG_upper].u_obj);
+
+    std::vector<RLEBand> bands;
+
+    // Each row of the mask is computed by op_inRange_row() into the line
+    // buffer, with the bounds converted once up front
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        InRangeBounds bounds = op_inRange_bounds(src.size(), src.type(), lower, upper);
+        bands = rle_encode(src.rows, src.cols, [&](int y, Mat& line) {
+            op_inRange_row(bounds, src.row(y), y, line);
+            return line.ptr<uchar>();
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    return rle_new(&cv2_rle_type, src.rows, src.cols, bands);
+}
+
+mp_obj_t cv2_rle_thresholdRLE(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    CV2_PROFILE_FUNCTION();
+
+    // Define the arguments
+    enum { ARG_src, ARG_thresh, ARG_type };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_thresh, MP_ARG_REQUIRED | MP_ARG_OBJ, { .u_obj = MP_OBJ_NULL } },
+        { MP_QSTR_type, MP_ARG_INT, { .u_int = THRESH_BINARY } },
+    };
+
+    // Parse the arguments
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    // Convert arguments to required types
+    Mat src = mp_obj_to_mat(args[ARG_src].u_obj);
+    mp_float_t thresh = mp_obj_get_float(args[ARG_thresh].u_obj);
+    int type = args[ARG_type].u_int;
+
+    std::vector<RLEBand> bands;
+
+    // Each row of the mask is computed by op_threshold() into the line buffer.
+    // Otsu's and the triangle methods need the whole image to pick the
+    // threshold, so they aren't supported
+    CV2_PROFILE_PHASE(COMPUTE);
+    try {
+        CV_Assert(src.type() == CV_8UC1);
+        CV_Assert(!(type & (THRESH_OTSU | THRESH_TRIANGLE)));
+        bands = rle_encode(src.rows, src.cols, [&](int y, Mat& line) {
+            op_threshold(src.row(y), line, thresh, 255, type);
+            return line.ptr<uchar>();
+        });
+    } catch(Exception& e) {
+        mp_raise_msg(&mp_type_Exception, MP_ERROR_TEXT(e.what()));
+    }
+
+    // Return the result
+    CV2_PROFILE_PHASE(CONVERT_OUT);
+    mp_obj_t result[2];
+    result[0] = mp_obj_new_float(thresh);
+    result[1] = rle_new(&cv2_rle_type, src.rows, src.cols, bands);
+    return mp_obj_new_tuple(2, result);
+}
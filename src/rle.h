@@ -0,0 +1,33 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * rle.h
+ * 
+ * MicroPython wrappers for run-length encoded masks, see rle.cpp.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "py/runtime.h"
+
+// Type definitions, see rle.c
+extern const mp_obj_type_t cv2_rle_type;
+
+// Function declarations
+extern mp_obj_t cv2_rle_inRangeRLE(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+extern mp_obj_t cv2_rle_thresholdRLE(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args);
+
+// Python references to the functions
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_rle_inRangeRLE_obj, 3, cv2_rle_inRangeRLE);
+static MP_DEFINE_CONST_FUN_OBJ_KW(cv2_rle_thresholdRLE_obj, 2, cv2_rle_thresholdRLE);
+
+// Global definitions for functions and constants
+#define OPENCV_RLE_GLOBALS \
+    /* Types */ \
+    { MP_ROM_QSTR(MP_QSTR_RLEMask), MP_ROM_PTR(&cv2_rle_type) }, \
+    /* Functions */ \
+    { MP_ROM_QSTR(MP_QSTR_inRangeRLE), MP_ROM_PTR(&cv2_rle_inRangeRLE_obj) }, \
+    { MP_ROM_QSTR(MP_QSTR_thresholdRLE), MP_ROM_PTR(&cv2_rle_thresholdRLE_obj) }
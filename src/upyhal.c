@@ -0,0 +1,563 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * upyhal.c
+ * 
+ * OpenCV HAL with packed 8-bit kernels. Each 32-bit word holds 4 pixels (or
+ * channels), which get processed together. On the Cortex-M33 the DSP extension
+ * does this directly (UQADD8, USUB8 + SEL, etc.), and elsewhere it's done with
+ * the usual bit tricks that keep carries from crossing byte boundaries.
+ * 
+ * Every kernel must give exactly the same result as OpenCV's own code. Anything
+ * a kernel doesn't handle returns CV_HAL_ERROR_NOT_IMPLEMENTED, and OpenCV then
+ * falls back to its own implementation.
+ *------------------------------------------------------------------------------
+ */
+
+// C headers
+#include "opencv2/core/hal/interface.h"
+#include "upyhal.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#define UPYHAL_SIMD32 1
+#else
+#define UPYHAL_SIMD32 0
+#endif
+
+// Threshold types, from opencv2/imgproc.hpp
+enum {
+    UPYHAL_THRESH_BINARY = 0,
+    UPYHAL_THRESH_BINARY_INV = 1,
+    UPYHAL_THRESH_TRUNC = 2,
+    UPYHAL_THRESH_TOZERO = 3,
+    UPYHAL_THRESH_TOZERO_INV = 4,
+};
+
+// Byte masks for the portable kernels
+#define SWAR_HIGH 0x80808080u
+#define SWAR_LOW 0x7F7F7F7Fu
+#define SWAR_ONES 0x01010101u
+
+// Rows aren't necessarily aligned, but the M33 handles unaligned word accesses
+static inline uint32_t swar_load(const uchar *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void swar_store(uchar *p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// Expands the high bit of each byte into the whole byte
+static inline uint32_t swar_expand(uint32_t high) {
+    return (high >> 7) * 0xFF;
+}
+
+// Returns 0xFF in each byte where a >= b, and 0x00 elsewhere
+static inline uint32_t swar_cmpge(uint32_t a, uint32_t b) {
+#if UPYHAL_SIMD32
+    (void)__usub8(a, b);
+    return __sel(0xFFFFFFFFu, 0);
+#else
+    // The high bit of d is set where the low 7 bits of a are >= those of b. If
+    // the high bits of a and b differ, they decide the result instead
+    uint32_t d = (a | SWAR_HIGH) - (b & SWAR_LOW);
+    return swar_expand(((a & ~b) | (~(a ^ b) & d)) & SWAR_HIGH);
+#endif
+}
+
+// Takes each byte from a where mask is 0xFF, and from b where it's 0x00
+static inline uint32_t swar_select(uint32_t mask, uint32_t a, uint32_t b) {
+    return (a & mask) | (b & ~mask);
+}
+
+// Saturating a + b
+static inline uint32_t swar_addsat(uint32_t a, uint32_t b) {
+#if UPYHAL_SIMD32
+    return __uqadd8(a, b);
+#else
+    uint32_t t = (a & SWAR_LOW) + (b & SWAR_LOW);
+    uint32_t carry = ((a & b) | ((a | b) & t)) & SWAR_HIGH;
+    return (t ^ ((a ^ b) & SWAR_HIGH)) | swar_expand(carry);
+#endif
+}
+
+// Saturating a - b
+static inline uint32_t swar_subsat(uint32_t a, uint32_t b) {
+#if UPYHAL_SIMD32
+    return __uqsub8(a, b);
+#else
+    uint32_t t = ((a | SWAR_HIGH) - (b & SWAR_LOW)) ^ ((a ^ ~b) & SWAR_HIGH);
+    uint32_t borrow = ((~a & b) | (~(a ^ b) & t)) & SWAR_HIGH;
+    return t & ~swar_expand(borrow);
+#endif
+}
+
+// |a - b|
+static inline uint32_t swar_absdiff(uint32_t a, uint32_t b) {
+    return swar_subsat(a, b) | swar_subsat(b, a);
+}
+
+static inline uchar sat_u8(int v) {
+    return (uchar)(v < 0 ? 0 : v > 255 ? 255 : v);
+}
+
+enum {
+    BINARY_ADD,
+    BINARY_SUB,
+    BINARY_ABSDIFF,
+};
+
+// Shared loop for the element-wise arithmetic. op is a constant in each caller,
+// so the switch gets folded away after inlining
+static inline int binary_8u(int op, const uchar *src1_data, size_t src1_step, const uchar *src2_data, size_t src2_step, uchar *dst_data, size_t dst_step, int width, int height) {
+    for(int y = 0; y < height; y++) {
+        const uchar *a = src1_data + y * src1_step;
+        const uchar *b = src2_data + y * src2_step;
+        uchar *d = dst_data + y * dst_step;
+        int x = 0;
+        for(; x <= width - 4; x += 4) {
+            uint32_t va = swar_load(a + x);
+            uint32_t vb = swar_load(b + x);
+            uint32_t vd;
+            switch(op) {
+                case BINARY_ADD: vd = swar_addsat(va, vb); break;
+                case BINARY_SUB: vd = swar_subsat(va, vb); break;
+                default: vd = swar_absdiff(va, vb); break;
+            }
+            swar_store(d + x, vd);
+        }
+        for(; x < width; x++) {
+            switch(op) {
+                case BINARY_ADD: d[x] = sat_u8(a[x] + b[x]); break;
+                case BINARY_SUB: d[x] = sat_u8(a[x] - b[x]); break;
+                default: d[x] = (uchar)abs(a[x] - b[x]); break;
+            }
+        }
+    }
+    return CV_HAL_ERROR_OK;
+}
+
+int upyhal_add8u(const uchar *src1_data, size_t src1_step, const uchar *src2_data, size_t src2_step, uchar *dst_data, size_t dst_step, int width, int height) {
+    return binary_8u(BINARY_ADD, src1_data, src1_step, src2_data, src2_step, dst_data, dst_step, width, height);
+}
+
+int upyhal_sub8u(const uchar *src1_data, size_t src1_step, const uchar *src2_data, size_t src2_step, uchar *dst_data, size_t dst_step, int width, int height) {
+    return binary_8u(BINARY_SUB, src1_data, src1_step, src2_data, src2_step, dst_data, dst_step, width, height);
+}
+
+int upyhal_absdiff8u(const uchar *src1_data, size_t src1_step, const uchar *src2_data, size_t src2_step, uchar *dst_data, size_t dst_step, int width, int height) {
+    return binary_8u(BINARY_ABSDIFF, src1_data, src1_step, src2_data, src2_step, dst_data, dst_step, width, height);
+}
+
+int upyhal_threshold(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step, int width, int height, int depth, int cn, double thresh, double maxValue, int thresholdType) {
+    // cv::threshold() has already handled the Otsu and triangle methods, and
+    // the thresholds that make the result constant, by the time it gets here.
+    // Anything else is left to OpenCV
+    int ithresh = (int)floor(thresh);
+    if(depth != CV_8U || ithresh < 0 || ithresh >= 255 || thresholdType < UPYHAL_THRESH_BINARY || thresholdType > UPYHAL_THRESH_TOZERO_INV) {
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+    int imaxval = sat_u8((int)lrint(maxValue));
+
+    // Every type selects between two values, depending on whether src > thresh.
+    // Each value is a constant, the source pixel, or zero
+    uint32_t hi_const = 0, hi_src = 0, lo_const = 0, lo_src = 0;
+    switch(thresholdType) {
+        case UPYHAL_THRESH_BINARY: hi_const = imaxval * SWAR_ONES; break;
+        case UPYHAL_THRESH_BINARY_INV: lo_const = imaxval * SWAR_ONES; break;
+        case UPYHAL_THRESH_TRUNC: hi_const = ithresh * SWAR_ONES; lo_src = 0xFFFFFFFFu; break;
+        case UPYHAL_THRESH_TOZERO: hi_src = 0xFFFFFFFFu; break;
+        case UPYHAL_THRESH_TOZERO_INV: lo_src = 0xFFFFFFFFu; break;
+    }
+
+    // src > thresh is the same as src >= thresh + 1, which fits in a byte
+    uint32_t above = (ithresh + 1) * SWAR_ONES;
+    width *= cn;
+    for(int y = 0; y < height; y++) {
+        const uchar *s = src_data + y * src_step;
+        uchar *d = dst_data + y * dst_step;
+        int x = 0;
+        for(; x <= width - 4; x += 4) {
+            uint32_t v = swar_load(s + x);
+            uint32_t mask = swar_cmpge(v, above);
+            swar_store(d + x, swar_select(mask, hi_const | (v & hi_src), lo_const | (v & lo_src)));
+        }
+        for(; x < width; x++) {
+            uint32_t v = s[x];
+            d[x] = (uchar)(v > (uint32_t)ithresh ? (hi_const | (v & hi_src)) : (lo_const | (v & lo_src)));
+        }
+    }
+    return CV_HAL_ERROR_OK;
+}
+
+void upyhal_inRange8u(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step, int width, int height, int cn, const uchar *lower, const uchar *upper) {
+    // Repeat the bounds to fill whole words. 4 pixels always fill a whole number
+    // of words, for any number of channels up to 4
+    uchar lo_bytes[16], hi_bytes[16];
+    for(int i = 0; i < 4 * cn; i++) {
+        lo_bytes[i] = lower[i % cn];
+        hi_bytes[i] = upper[i % cn];
+    }
+    uint32_t lo[4], hi[4];
+    for(int i = 0; i < cn; i++) {
+        lo[i] = swar_load(lo_bytes + 4 * i);
+        hi[i] = swar_load(hi_bytes + 4 * i);
+    }
+
+    for(int y = 0; y < height; y++) {
+        const uchar *s = src_data + y * src_step;
+        uchar *d = dst_data + y * dst_step;
+        int x = 0;
+        for(; x <= width - 4; x += 4, s += 4 * cn, d += 4) {
+            // 0xFF in each byte that's within its channel's range
+            uint32_t m[4];
+            for(int i = 0; i < cn; i++) {
+                uint32_t v = swar_load(s + 4 * i);
+                m[i] = swar_cmpge(v, lo[i]) & swar_cmpge(hi[i], v);
+            }
+
+            // A pixel is in range only if all of its channels are
+            uint32_t out;
+            switch(cn) {
+                case 1:
+                    out = m[0];
+                    break;
+                case 2: {
+                    uint32_t m0 = m[0] & (m[0] >> 8);
+                    uint32_t m1 = m[1] & (m[1] >> 8);
+                    out = (m0 & 0xFF) | ((m0 >> 8) & 0xFF00) | ((m1 & 0xFF) << 16) | ((m1 & 0xFF0000) << 8);
+                    break;
+                }
+                case 3: {
+                    uint32_t p0 = m[0] & (m[0] >> 8) & (m[0] >> 16);
+                    uint32_t p1 = (m[0] >> 24) & m[1] & (m[1] >> 8);
+                    uint32_t p2 = (m[1] >> 16) & (m[1] >> 24) & m[2];
+                    uint32_t p3 = (m[2] >> 8) & (m[2] >> 16) & (m[2] >> 24);
+                    out = (p0 & 0xFF) | ((p1 & 0xFF) << 8) | ((p2 & 0xFF) << 16) | ((p3 & 0xFF) << 24);
+                    break;
+                }
+                default:
+                    out = (m[0] == 0xFFFFFFFFu ? 0xFFu : 0) | (m[1] == 0xFFFFFFFFu ? 0xFF00u : 0) |
+                        (m[2] == 0xFFFFFFFFu ? 0xFF0000u : 0) | (m[3] == 0xFFFFFFFFu ? 0xFF000000u : 0);
+                    break;
+            }
+            swar_store(d, out);
+        }
+        for(; x < width; x++, s += cn, d++) {
+            uchar ok = 255;
+            for(int i = 0; i < cn; i++) {
+                if(s[i] < lower[i] || s[i] > upper[i]) {
+                    ok = 0;
+                }
+            }
+            *d = ok;
+        }
+    }
+}
+
+// Fixed point tables of OpenCV's 8-bit BGR to HSV conversion (RGB2HSV_b), so
+// the fused kernel below computes exactly the same H, S and V. They're filled
+// by upyhal_inRangeHSV8u_init() on the calling core, before the kernel gets
+// split across both cores, so the worker never sees them half written
+#define HSV_SHIFT 12
+static int hsv_sdiv[256];
+static int hsv_hdiv180[256];
+static bool hsv_tables_ready = false;
+
+void upyhal_inRangeHSV8u_init(void) {
+    if(hsv_tables_ready) {
+        return;
+    }
+    hsv_sdiv[0] = hsv_hdiv180[0] = 0;
+    for(int i = 1; i < 256; i++) {
+        hsv_sdiv[i] = (int)lrint((255 << HSV_SHIFT) / (1. * i));
+        hsv_hdiv180[i] = (int)lrint((180 << HSV_SHIFT) / (6. * i));
+    }
+    hsv_tables_ready = true;
+}
+
+void upyhal_inRangeHSV8u(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step, int width, int height, int cn, const uchar *lower, const uchar *upper) {
+    // Each bound becomes a table of 0xFF for the values in range, so a pixel
+    // is tested with three lookups and no branches. The hue range wraps
+    // around when lower > upper, eg. 170 to 10 for red
+    uchar h_ok[256], s_ok[256], v_ok[256];
+    for(int i = 0; i < 256; i++) {
+        bool h_in = lower[0] <= upper[0] ? (i >= lower[0] && i <= upper[0]) : (i >= lower[0] || i <= upper[0]);
+        h_ok[i] = h_in ? 255 : 0;
+        s_ok[i] = i >= lower[1] && i <= upper[1] ? 255 : 0;
+        v_ok[i] = i >= lower[2] && i <= upper[2] ? 255 : 0;
+    }
+
+    const int round = 1 << (HSV_SHIFT - 1);
+    for(int y = 0; y < height; y++) {
+        const uchar *p = src_data + y * src_step;
+        uchar *d = dst_data + y * dst_step;
+        for(int x = 0; x < width; x++, p += cn) {
+            int b = p[0], g = p[1], r = p[2];
+            int v = b > g ? b : g;
+            v = v > r ? v : r;
+
+            // Most pixels of a typical range fail on V, which needs no math
+            if(!v_ok[v]) {
+                d[x] = 0;
+                continue;
+            }
+            int vmin = b < g ? b : g;
+            vmin = vmin < r ? vmin : r;
+            int diff = v - vmin;
+            int vr = v == r ? -1 : 0;
+            int vg = v == g ? -1 : 0;
+
+            int s = (diff * hsv_sdiv[v] + round) >> HSV_SHIFT;
+            int h = (vr & (g - b)) + (~vr & ((vg & (b - r + 2 * diff)) + (~vg & (r - g + 4 * diff))));
+            h = (h * hsv_hdiv180[diff] + round) >> HSV_SHIFT;
+            h += h < 0 ? 180 : 0;
+            d[x] = h_ok[h] & s_ok[s];
+        }
+    }
+}
+
+// Same as cv::borderInterpolate(). Returns -1 for pixels of a constant border
+static int border_interpolate(int p, int len, int border_type) {
+    if((unsigned)p < (unsigned)len) {
+        return p;
+    }
+    if(border_type == CV_HAL_BORDER_REPLICATE) {
+        p = p < 0 ? 0 : len - 1;
+    }
+    else if(border_type == CV_HAL_BORDER_REFLECT || border_type == CV_HAL_BORDER_REFLECT_101) {
+        int delta = border_type == CV_HAL_BORDER_REFLECT_101;
+        if(len == 1) {
+            return 0;
+        }
+        do {
+            if(p < 0) {
+                p = -p - 1 + delta;
+            }
+            else {
+                p = len - 1 - (p - len) - delta;
+            }
+        } while((unsigned)p >= (unsigned)len);
+    }
+    else if(border_type == CV_HAL_BORDER_WRAP) {
+        if(p < 0) {
+            p -= ((p - len + 1) / len) * len;
+        }
+        if(p >= len) {
+            p %= len;
+        }
+    }
+    else {
+        p = -1;
+    }
+    return p;
+}
+
+// State for the box filter
+typedef struct {
+    const uchar *src_data;
+    size_t src_step;
+    int width;
+    int cn;
+    int margin_top;
+    int full_height;
+    int border_type;
+    int anchor_x;
+    int *col_map;
+} box_rows_t;
+
+// Copies source row r (relative to the ROI) into out, including the border
+// columns on both sides. Pixels outside the ROI but inside the parent image
+// are real pixels, just like OpenCV's own filters use them
+static void box_fetch_row(const box_rows_t *b, int r, uchar *out, int ext_width) {
+    int p = border_interpolate(r + b->margin_top, b->full_height, b->border_type);
+    if(p < 0) {
+        memset(out, 0, ext_width * b->cn);
+        return;
+    }
+    const uchar *row = b->src_data + (ptrdiff_t)(p - b->margin_top) * (ptrdiff_t)b->src_step;
+    for(int i = 0; i < ext_width; i++) {
+        if(i == b->anchor_x) {
+            // The ROI itself can be copied as-is
+            memcpy(out + i * b->cn, row, b->width * b->cn);
+            i += b->width - 1;
+            continue;
+        }
+        int col = b->col_map[i];
+        for(int c = 0; c < b->cn; c++) {
+            out[i * b->cn + c] = col == INT32_MIN ? 0 : row[col * b->cn + c];
+        }
+    }
+}
+
+// Adds or subtracts a row of bytes to the column sums. The sums are 16 bits, 2
+// per word, with even bytes in one word and odd bytes in the next. That way a
+// word of pixels is split with 2 masks and no shuffling
+static inline void box_accumulate(uint32_t *sums, const uchar *row, int words, bool add) {
+    for(int i = 0; i < words; i++) {
+        uint32_t v = swar_load(row + 4 * i);
+        uint32_t even = v & 0x00FF00FFu;
+        uint32_t odd = (v >> 8) & 0x00FF00FFu;
+        if(add) {
+            sums[2 * i] += even;
+            sums[2 * i + 1] += odd;
+        }
+        else {
+            sums[2 * i] -= even;
+            sums[2 * i + 1] -= odd;
+        }
+    }
+}
+
+int upyhal_boxFilter(const uchar *src_data, size_t src_step, uchar *dst_data, size_t dst_step, int width, int height, int src_depth, int dst_depth, int cn, int margin_left, int margin_top, int margin_right, int margin_bottom, size_t ksize_width, size_t ksize_height, int anchor_x, int anchor_y, bool normalize, int border_type) {
+    int kw = (int)ksize_width, kh = (int)ksize_height;
+    border_type &= ~CV_HAL_BORDER_ISOLATED;
+
+    // Only normalized 8-bit filters (ie. cv::blur()), with column sums that fit
+    // in 16 bits
+    if(src_depth != CV_8U || dst_depth != CV_8U || !normalize || cn > 4 || kw < 1 || kh < 1 || kh > 257 || border_type == CV_HAL_BORDER_TRANSPARENT) {
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+
+    // cv::boxFilter() passes the anchor as given, and only resolves the default
+    // of (-1, -1) to the center later, when it falls back to OpenCV's own
+    // filter. Anchors outside the kernel are left to OpenCV to reject
+    if(anchor_x < 0) {
+        anchor_x = kw / 2;
+    }
+    if(anchor_y < 0) {
+        anchor_y = kh / 2;
+    }
+    if(anchor_x >= kw || anchor_y >= kh) {
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+
+    // Rows of dst get written before later rows of src are read, so the images
+    // must not overlap
+    const uchar *src_start = src_data - (ptrdiff_t)margin_top * (ptrdiff_t)src_step - margin_left * cn;
+    const uchar *src_end = src_data + (ptrdiff_t)(height + margin_bottom - 1) * (ptrdiff_t)src_step + (width + margin_right) * cn;
+    const uchar *dst_end = dst_data + (ptrdiff_t)height * (ptrdiff_t)dst_step;
+    if(dst_data < src_end && src_start < dst_end) {
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+
+    int ext_width = width + kw - 1;
+    int row_bytes = ext_width * cn;
+    int words = (row_bytes + 3) / 4;
+    int padded = words * 4;
+
+    // Column map for the border columns, and a ring of the last kh rows. The
+    // padding at the end of each row stays zero, so it never adds to the sums
+    int *col_map = malloc(ext_width * sizeof(int));
+    uchar *ring = calloc(kh, padded);
+    uint32_t *sums = calloc(2 * words, sizeof(uint32_t));
+    uint16_t *row_sums = malloc(padded * sizeof(uint16_t));
+    if(!col_map || !ring || !sums || !row_sums) {
+        free(col_map);
+        free(ring);
+        free(sums);
+        free(row_sums);
+        return CV_HAL_ERROR_NOT_IMPLEMENTED;
+    }
+
+    int full_width = margin_left + width + margin_right;
+    for(int i = 0; i < ext_width; i++) {
+        int p = border_interpolate(i - anchor_x + margin_left, full_width, border_type);
+        col_map[i] = p < 0 ? INT32_MIN : p - margin_left;
+    }
+
+    box_rows_t b = {
+        .src_data = src_data,
+        .src_step = src_step,
+        .width = width,
+        .cn = cn,
+        .margin_top = margin_top,
+        .full_height = margin_top + height + margin_bottom,
+        .border_type = border_type,
+        .anchor_x = anchor_x,
+        .col_map = col_map,
+    };
+
+    // Same fixed point division as OpenCV's ColumnSum<ushort, uchar>, which it
+    // uses when the sum of the whole kernel fits in 16 bits. Larger kernels are
+    // rounded from a double, like ColumnSum<int, uchar>
+    int area = kw * kh;
+    bool fixed = area <= 256;
+    int div_scale = 1, div_delta = 0;
+    double scale = 1.0 / area;
+    if(fixed && area != 1) {
+        double scalef = ((double)(1 << 16)) / area;
+        div_scale = (int)floor(scalef);
+        scalef -= div_scale;
+        div_delta = area / 2;
+        if(scalef < 0.5) {
+            div_delta++;
+        }
+        else {
+            div_scale++;
+        }
+    }
+
+    for(int k = 0; k < kh; k++) {
+        box_fetch_row(&b, k - anchor_y, ring + k * padded, ext_width);
+        box_accumulate(sums, ring + k * padded, words, true);
+    }
+
+    for(int y = 0; y < height; y++) {
+        // Unpack the column sums into the order of the bytes
+        for(int i = 0; i < words; i++) {
+            uint32_t even = sums[2 * i], odd = sums[2 * i + 1];
+            row_sums[4 * i] = (uint16_t)even;
+            row_sums[4 * i + 1] = (uint16_t)odd;
+            row_sums[4 * i + 2] = (uint16_t)(even >> 16);
+            row_sums[4 * i + 3] = (uint16_t)(odd >> 16);
+        }
+
+        // Slide the window along the row
+        uchar *d = dst_data + y * dst_step;
+        for(int c = 0; c < cn; c++) {
+            uint32_t s = 0;
+            for(int i = 0; i < kw; i++) {
+                s += row_sums[i * cn + c];
+            }
+            for(int x = 0; x < width; x++) {
+                if(area == 1) {
+                    d[x * cn + c] = (uchar)s;
+                }
+                else if(fixed) {
+                    d[x * cn + c] = (uchar)(((s + div_delta) * div_scale) >> 16);
+                }
+                else {
+                    d[x * cn + c] = sat_u8((int)lrint(s * scale));
+                }
+                if(x + 1 < width) {
+                    s += row_sums[(x + kw) * cn + c] - row_sums[x * cn + c];
+                }
+            }
+        }
+
+        // Replace the oldest row in the window with the next one
+        if(y + 1 < height) {
+            uchar *slot = ring + (y % kh) * padded;
+            box_accumulate(sums, slot, words, false);
+            box_fetch_row(&b, y + kh - anchor_y, slot, ext_width);
+            box_accumulate(sums, slot, words, true);
+        }
+    }
+
+    free(col_map);
+    free(ring);
+    free(sums);
+    free(row_sums);
+    return CV_HAL_ERROR_OK;
+}
@@ -0,0 +1,72 @@
+/*
+ *------------------------------------------------------------------------------
+ * SPDX-License-Identifier: MIT
+ * 
+ * Copyright (c) 2025 SparkFun Electronics
+ *------------------------------------------------------------------------------
+ * upyhal.h
+ * 
+ * OpenCV HAL with packed 8-bit kernels. OpenCV is built without intrinsics, so
+ * its 8-bit kernels process one byte at a time. These process 4 bytes per
+ * 32-bit word instead (SIMD within a register), using the Cortex-M33 DSP
+ * instructions when available, and portable C elsewhere (eg. Linux).
+ * 
+ * This header is included by OpenCV itself (see platforms/upyhal), where it
+ * replaces the `cv_hal_*` hooks, and by the cv2 module for the prototypes.
+ * It deliberately has no include guard around the hook replacements, because
+ * OpenCV includes it once for each module's hal_replacement.hpp.
+ *------------------------------------------------------------------------------
+ */
+
+#ifndef UPYHAL_H
+#define UPYHAL_H
+
+// C headers
+#include <stddef.h>
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Replacements for OpenCV core HAL hooks
+int upyhal_add8u(const unsigned char *src1_data, size_t src1_step, const unsigned char *src2_data, size_t src2_step, unsigned char *dst_data, size_t dst_step, int width, int height);
+int upyhal_sub8u(const unsigned char *src1_data, size_t src1_step, const unsigned char *src2_data, size_t src2_step, unsigned char *dst_data, size_t dst_step, int width, int height);
+int upyhal_absdiff8u(const unsigned char *src1_data, size_t src1_step, const unsigned char *src2_data, size_t src2_step, unsigned char *dst_data, size_t dst_step, int width, int height);
+
+// Replacements for OpenCV imgproc HAL hooks
+int upyhal_threshold(const unsigned char *src_data, size_t src_step, unsigned char *dst_data, size_t dst_step, int width, int height, int depth, int cn, double thresh, double maxValue, int thresholdType);
+int upyhal_boxFilter(const unsigned char *src_data, size_t src_step, unsigned char *dst_data, size_t dst_step, int width, int height, int src_depth, int dst_depth, int cn, int margin_left, int margin_top, int margin_right, int margin_bottom, size_t ksize_width, size_t ksize_height, int anchor_x, int anchor_y, bool normalize, int border_type);
+
+// Kernels without an OpenCV HAL hook, which are called by the cv2 wrappers
+void upyhal_inRange8u(const unsigned char *src_data, size_t src_step, unsigned char *dst_data, size_t dst_step, int width, int height, int cn, const unsigned char *lower, const unsigned char *upper);
+void upyhal_inRangeHSV8u_init(void);
+void upyhal_inRangeHSV8u(const unsigned char *src_data, size_t src_step, unsigned char *dst_data, size_t dst_step, int width, int height, int cn, const unsigned char *lower, const unsigned char *upper);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // UPYHAL_H
+
+// Replace the core hooks when included from core/src/hal_replacement.hpp
+#if defined(OPENCV_CORE_HAL_REPLACEMENT_HPP) && !defined(UPYHAL_CORE_REPLACED)
+#define UPYHAL_CORE_REPLACED
+#undef cv_hal_add8u
+#define cv_hal_add8u upyhal_add8u
+#undef cv_hal_sub8u
+#define cv_hal_sub8u upyhal_sub8u
+#undef cv_hal_absdiff8u
+#define cv_hal_absdiff8u upyhal_absdiff8u
+#endif
+
+// Replace the imgproc hooks when included from imgproc/src/hal_replacement.hpp
+#if defined(OPENCV_IMGPROC_HAL_REPLACEMENT_HPP) && !defined(UPYHAL_IMGPROC_REPLACED)
+#define UPYHAL_IMGPROC_REPLACED
+#undef cv_hal_threshold
+#define cv_hal_threshold upyhal_threshold
+#undef cv_hal_boxFilter
+#define cv_hal_boxFilter upyhal_boxFilter
+#endif